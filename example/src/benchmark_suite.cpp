@@ -0,0 +1,44 @@
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+#include <vector>
+
+#include "shineknightdev/benchmark_registry.hpp"
+#include "shineknightdev/sample_utilities.hpp"
+
+// --------------------------------------------------------------------------------------------------------------------
+// Benchmark Suite
+//
+// Registers a few sorting and scanning benchmarks with SRA_BENCHMARK and runs them with the shared command-line
+// runner. Run with --help for the options, e.g. --filter=sort --format=json or --output=data --format=csv.
+// --------------------------------------------------------------------------------------------------------------------
+
+namespace
+{
+
+std::vector<std::vector<int>> random_samples()
+{
+    const sra::SampleFiller<int> random_ints({.kind = sra::Distribution::uniform, .max = 10000, .seed = 2025});
+    return sra::generate_samples<int>(random_ints, sra::generate_sizes(8, 100000, sra::SampleSizeConfig{}));
+}
+
+long long sum_values(const std::vector<int>& sample)
+{
+    return std::accumulate(sample.begin(), sample.end(), 0LL);
+}
+
+} // namespace
+
+SRA_BENCHMARK("scan/accumulate", sum_values, random_samples, sra::MeasurementPolicy{.repetitions = 15});
+
+SRA_BENCHMARK("sort/intro_sort",
+              sra::Fixture{.body = [](std::vector<int>& sample) { std::ranges::sort(sample); }},
+              random_samples,
+              sra::MeasurementPolicy{.repetitions = 5});
+
+SRA_BENCHMARK("sort/merge_sort",
+              sra::Fixture{.body = [](std::vector<int>& sample) { std::ranges::stable_sort(sample); }},
+              random_samples,
+              sra::MeasurementPolicy{.repetitions = 5});
+
+SRA_BENCHMARK_MAIN()
@@ -3,13 +3,19 @@
 #include <cstddef>
 #include <filesystem>
 #include <iostream>
-#include <random>
 #include <thread>
 #include <vector>
 
+#define SRA_ALLOCATION_HOOKS
+#include "shineknightdev/allocation_tracker.hpp"
+#include "shineknightdev/parallel_profiler.hpp"
+#include "shineknightdev/profile_loader.hpp"
+#include "shineknightdev/regression_detector.hpp"
 #include "shineknightdev/runtime_analyzer.hpp"
 #include "shineknightdev/runtime_reporter.hpp"
+#include "shineknightdev/sample_archive.hpp"
 #include "shineknightdev/sample_utilities.hpp"
+#include "shineknightdev/zone_profiler.hpp"
 
 // --------------------------------------------------------------------------------------------------------------------
 // Example Application for Simple Runtime Analyzer
@@ -19,9 +25,8 @@
 // --------------------------------------------------------------------------------------------------------------------
 
 // Forward declarations for example functions
-void sort_sample(std::vector<int> sample, bool use_stable_sort);
-void bubble_sort(std::vector<int> sample);
-void fill_with_random_ints(std::vector<int>& vec, size_t size);
+void sort_sample(std::vector<int>& sample, bool use_stable_sort);
+void bubble_sort(std::vector<int>& sample);
 int execute_command(const std::string& command);
 bool generate_plot(const std::vector<std::string>& data_files);
 
@@ -36,6 +41,8 @@ int main()
     constexpr size_t sample_count = 10;
     constexpr size_t max_sample_size = 100000;
     const sra::SampleSizeConfig size_config = {.round_to = 200, .bias = 1.5};
+    const sra::MeasurementPolicy sort_policy = {
+        .warmup_runs = 1, .repetitions = 5, .track_allocations = true, .record_timeline = true};
 
     std::cout << "=== Simple Runtime Analyzer Example ===\n\n";
 
@@ -51,7 +58,18 @@ int main()
         std::this_thread::sleep_for(std::chrono::milliseconds(50));
     });
 
-    std::cout << "   Duration: " << single_op_duration.count() << " ms\n\n";
+    std::cout << "   Duration: " << single_op_duration.count() << " ms\n";
+
+    // A million runs of a fast call, kept as a fixed-size latency histogram instead of one value per run
+    std::cout << "⏱️  Measuring a binary search one million times...\n";
+    const sra::MeasurementPolicy lookup_policy = {.repetitions = 1000000, .histogram_storage = true};
+    const std::vector<std::vector<int>> lookup_samples = {std::vector<int>(4096, 1)};
+    const auto lookup_profile = sra::profile_runtime<std::chrono::nanoseconds>(
+        lookup_policy, [](const std::vector<int>& sample) { return std::ranges::binary_search(sample, 2); },
+        lookup_samples);
+    const auto& lookup_latencies = lookup_profile.histograms.front();
+    std::cout << "   p50: " << lookup_latencies.percentile(0.5) << " ns | p99.9: " << lookup_latencies.percentile(0.999)
+              << " ns | max: " << lookup_latencies.max() << " ns\n\n";
 
     // ----------------------------------------------------------------------------------------------------------------
     // 2. Test Data Generation
@@ -62,8 +80,10 @@ int main()
     std::cout << "📊 Generating sample size distribution...\n";
     std::vector<size_t> sizes = sra::generate_sizes(sample_count, max_sample_size, size_config);
 
+    // Seeded filler, every run sorts exactly the same data
     std::cout << "🧪 Creating sample data with random integers...\n";
-    auto samples = sra::generate_samples<int>(fill_with_random_ints, sizes);
+    const sra::SampleFiller<int> random_ints({.kind = sra::Distribution::uniform, .max = 10000, .seed = 2025});
+    auto samples = sra::generate_samples<int>(random_ints, sizes);
 
     std::cout << "   Generated " << samples.size() << " samples with sizes ranging from " << sizes.front() << " to "
               << sizes.back() << " elements\n\n";
@@ -75,9 +95,17 @@ int main()
     std::cout << "--------------------------------\n";
 
     std::cout << "🚀 Profiling sorting algorithm performance...\n";
-    auto intro_sort_profile_in_us = sra::profile_runtime<std::chrono::microseconds>(sort_sample, samples, false);
-    auto merge_sort_profile_in_us = sra::profile_runtime<std::chrono::microseconds>(sort_sample, samples, true);
-    auto bubble_sort_profile_in_us = sra::profile_runtime<std::chrono::microseconds>(bubble_sort, samples);
+    // Aggregates the SRA_ZONE scopes inside the sort functions over every call made while profiling, and keeps each
+    // zone event for the trace
+    sra::ZoneCollector zone_collector(true);
+    // The sorts work in place, so each timed call gets a fresh copy of the sample, made outside the timed region
+    const sra::Fixture intro_sort{.body = [](std::vector<int>& sample) { sort_sample(sample, false); }};
+    const sra::Fixture merge_sort{.body = [](std::vector<int>& sample) { sort_sample(sample, true); }};
+    auto intro_sort_profile_in_us = sra::profile_runtime<std::chrono::microseconds>(sort_policy, intro_sort, samples);
+    auto merge_sort_profile_in_us = sra::profile_runtime<std::chrono::microseconds>(sort_policy, merge_sort, samples);
+    // Bubble sort is slow at large sizes, so its samples are measured in parallel on pinned cores
+    auto bubble_sort_profile_in_us = sra::profile_runtime_parallel<std::chrono::microseconds>(
+        sra::MeasurementPolicy{}, sra::ParallelConfig{}, sra::Fixture{.body = bubble_sort}, samples);
 
     std::cout << "   Profiling completed with " << samples.size() << " data points\n\n";
 
@@ -92,7 +120,24 @@ int main()
     auto merge_sort_profile_in_ns = merge_sort_profile_in_us.convert_to<std::chrono::nanoseconds>();
     auto bubble_sort_profile_in_ns = bubble_sort_profile_in_us.convert_to<std::chrono::nanoseconds>();
 
-    std::cout << "   Time unit conversion: microseconds → nanoseconds\n\n";
+    std::cout << "   Time unit conversion: microseconds → nanoseconds\n";
+
+    std::cout << "📐 Fitting empirical complexity...\n";
+    intro_sort_profile_in_ns.complexity = sra::fit_complexity(intro_sort_profile_in_ns);
+    merge_sort_profile_in_ns.complexity = sra::fit_complexity(merge_sort_profile_in_ns);
+    bubble_sort_profile_in_ns.complexity = sra::fit_complexity(bubble_sort_profile_in_ns);
+
+    std::cout << "   IntroSort: " << sra::to_string(intro_sort_profile_in_ns.complexity->best_fit().complexity)
+              << " | MergeSort: " << sra::to_string(merge_sort_profile_in_ns.complexity->best_fit().complexity)
+              << " | BubbleSort: " << sra::to_string(bubble_sort_profile_in_ns.complexity->best_fit().complexity)
+              << "\n";
+
+    // In CI the baseline would be a report of the previous build, loaded with sra::load_profile
+    std::cout << "⚖️ Checking IntroSort against MergeSort as the baseline...\n";
+    const auto sort_comparison = sra::compare_profiles(merge_sort_profile_in_ns, intro_sort_profile_in_ns);
+    std::cout << "   Verdict: " << sra::to_string(sort_comparison.verdict) << " ("
+              << sort_comparison.count(sra::PerformanceChange::improved) << " of " << sort_comparison.sizes.size()
+              << " sizes faster, exit code " << sort_comparison.exit_code() << ")\n\n";
 
     // ----------------------------------------------------------------------------------------------------------------
     // 5. Results Reporting and Export
@@ -118,10 +163,26 @@ int main()
     sra::save_report(intro_sort_profile_in_ns, std::filesystem::path("data/intro_sort_report.csv"));
     sra::save_report(intro_sort_profile_in_ns, std::filesystem::path("data/intro_sort_report.json"));
     sra::save_report(intro_sort_profile_in_ns, std::filesystem::path("data/intro_sort_report.txt"));
+    sra::save_report(intro_sort_profile_in_ns, std::filesystem::path("data/intro_sort_report.srp"));
     sra::save_reports(merge_sort_profile_in_ns, std::filesystem::path("data/merge_sort_report"));
     sra::save_reports(bubble_sort_profile_in_ns, std::filesystem::path("data/bubble_sort_report"));
-
-    std::cout << "💾 Reports exported to data/\n\n";
+    sra::save_report(sort_comparison, std::filesystem::path("data/sort_comparison.json"));
+    const auto sort_zones = zone_collector.report();
+    sra::save_report(sort_zones, std::filesystem::path("data/sort_zones.json"));
+    // Open in https://ui.perfetto.dev to see each repetition and the zones inside it on one timeline
+    sra::save_trace("data/sort_timeline.trace", intro_sort_profile_in_ns, merge_sort_profile_in_ns, sort_zones);
+
+    std::cout << "💾 Reports exported to data/\n";
+    std::cout << "   " << sort_zones.zones.size() << " instrumentation zones recorded on " << sort_zones.threads
+              << " threads\n";
+
+    // Saved reports load back into profiles. Merging pools the repetitions of each size, e.g. from several machines;
+    // here the CSV report stands in for a second run
+    const auto reloaded_profile = sra::load_profile<std::chrono::nanoseconds>("data/intro_sort_report.srp");
+    const auto second_run = sra::load_profile<std::chrono::nanoseconds>("data/intro_sort_report.csv");
+    const auto pooled_profile = sra::merge_profiles(reloaded_profile, second_run);
+    std::cout << "   Reloaded " << reloaded_profile.size() << " samples, pooled with a second run into "
+              << pooled_profile.statistics(0).repetitions << " repetitions of the smallest size\n\n";
 
     // ----------------------------------------------------------------------------------------------------------------
     // 6. Sample Data Preservation
@@ -132,8 +193,9 @@ int main()
     std::cout << "💾 Archiving generated sample data...\n";
     sra::save_samples(samples, sra::serialize_iterable<std::vector<int>>, "data/samples.csv");
     sra::save_samples(samples, sra::serialize_iterable<std::vector<int>>, "data/samples.json");
+    sra::save_sample_archive(samples, "data/samples.sra");
 
-    std::cout << "   Sample data archived to data/samples.{csv,json}\n\n";
+    std::cout << "   Sample data archived to data/samples.{csv,json,sra}\n\n";
 
     // ----------------------------------------------------------------------------------------------------------------
     // 7. Data Visualization
@@ -171,17 +233,24 @@ int main()
 // Function Implementations
 // --------------------------------------------------------------------------------------------------------------------
 
-void sort_sample(std::vector<int> sample, bool use_stable_sort)
+void sort_sample(std::vector<int>& sample, bool use_stable_sort)
 {
-    if (use_stable_sort) { std::stable_sort(sample.begin(), sample.end()); }
+    SRA_ZONE("sort_sample");
+    if (use_stable_sort)
+    {
+        SRA_ZONE("std::stable_sort");
+        std::stable_sort(sample.begin(), sample.end());
+    }
     else
     {
+        SRA_ZONE("std::sort");
         std::sort(sample.begin(), sample.end());
     }
 }
 
-void bubble_sort(std::vector<int> sample)
+void bubble_sort(std::vector<int>& sample)
 {
+    SRA_ZONE("bubble_sort");
     size_t n = sample.size();
     bool swapped;
     for (size_t i = 0; i < n - 1; ++i)
@@ -200,18 +269,6 @@ void bubble_sort(std::vector<int> sample)
     }
 }
 
-void fill_with_random_ints(std::vector<int>& vec, size_t size)
-{
-    // Static random number generator for consistent performance
-    static std::mt19937 rng(std::random_device{}());
-    static std::uniform_int_distribution<int> dist(0, 10000);
-
-    vec.clear();
-    vec.reserve(size);
-
-    for (size_t i = 0; i < size; ++i) { vec.push_back(dist(rng)); }
-}
-
 int execute_command(const std::string& command)
 {
 #ifdef _WIN32
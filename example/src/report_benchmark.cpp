@@ -0,0 +1,138 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "shineknightdev/runtime_analyzer.hpp"
+#include "shineknightdev/runtime_reporter.hpp"
+
+// --------------------------------------------------------------------------------------------------------------------
+// Report Writer Benchmark
+//
+// Compares save_reports, which writes every format in one pass through preallocated buffers, with stream writers
+// that format each field with operator<< and serialize the profile once per format.
+// --------------------------------------------------------------------------------------------------------------------
+
+using Milliseconds = sra::Fractional<std::chrono::milliseconds>;
+using Nanoseconds = sra::Fractional<std::chrono::nanoseconds>;
+
+namespace baseline
+{
+
+// One optional cell as its own string, the way stream writers format each field
+std::string format_cell(const sra::detail::ExtraCell& cell)
+{
+    std::string value;
+    sra::detail::append_cell_value(value, cell, false);
+    return value;
+}
+
+void write_text(std::ostream& out, const sra::RuntimeProfile<Nanoseconds>& profile)
+{
+    for (size_t i = 0; i < profile.size(); ++i)
+    {
+        out << "Sample " << i + 1 << ": "
+            << "| Time: " << profile.raw_durations[i].count() << " " << profile.unit_symbol
+            << " | Sample size: " << profile.sample_sizes[i];
+        sra::detail::for_each_extra_cell(profile, i, [&out](const sra::detail::ExtraCell& cell) {
+            if (!cell.empty()) { out << " | " << cell.name << ": " << format_cell(cell); }
+        });
+        out << "\n";
+    }
+}
+
+void write_csv(std::ostream& out, const sra::RuntimeProfile<Nanoseconds>& profile)
+{
+    out << "sample_id,time_unit,time_value,sample_size\n";
+    for (size_t i = 0; i < profile.size(); ++i)
+    {
+        out << i + 1 << "," << profile.unit_symbol << "," << profile.raw_durations[i].count() << ","
+            << profile.sample_sizes[i];
+        sra::detail::for_each_extra_cell(
+            profile, i, [&out](const sra::detail::ExtraCell& cell) { out << "," << format_cell(cell); });
+        out << "\n";
+    }
+}
+
+void write_json(std::ostream& out, const sra::RuntimeProfile<Nanoseconds>& profile)
+{
+    out << "{\n  \"samples\": [\n";
+    for (size_t i = 0; i < profile.size(); ++i)
+    {
+        if (i > 0) { out << ",\n"; }
+        out << "    {\n"
+            << "      \"sample_id\": " << i + 1 << ",\n"
+            << "      \"time_unit\": \"" << profile.unit_symbol << "\",\n"
+            << "      \"time_value\": " << profile.raw_durations[i].count() << ",\n"
+            << "      \"sample_size\": " << profile.sample_sizes[i];
+        sra::detail::for_each_extra_cell(profile, i, [&out](const sra::detail::ExtraCell& cell) {
+            out << ",\n      \"" << cell.name << "\": " << (cell.empty() ? "null" : format_cell(cell));
+        });
+        out << "\n    }";
+    }
+    out << "\n  ]\n}\n";
+}
+
+void save_reports(const sra::RuntimeProfile<Nanoseconds>& profile, const std::filesystem::path& base_path)
+{
+    std::ofstream csv(std::filesystem::path(base_path).replace_extension(".csv"));
+    write_csv(csv, profile);
+    std::ofstream json(std::filesystem::path(base_path).replace_extension(".json"));
+    write_json(json, profile);
+    std::ofstream text(std::filesystem::path(base_path).replace_extension(".txt"));
+    write_text(text, profile);
+}
+
+} // namespace baseline
+
+// Best of `runs` wall times, in milliseconds
+template <typename Func>
+double best_of(size_t runs, Func&& func)
+{
+    double best = 0.0;
+    for (size_t run = 0; run < runs; ++run)
+    {
+        const double elapsed = sra::measure_duration<Milliseconds>(func).count();
+        best = run == 0 ? elapsed : std::min(best, elapsed);
+    }
+    return best;
+}
+
+int main()
+{
+    constexpr size_t rows = 1000000;
+    constexpr size_t runs = 3;
+
+    // Fractional times exercise floating-point formatting, the slowest path of both writers
+    std::vector<Nanoseconds> durations;
+    std::vector<size_t> sizes;
+    durations.reserve(rows);
+    sizes.reserve(rows);
+    for (size_t i = 0; i < rows; ++i)
+    {
+        sizes.push_back((i + 1) * 10);
+        durations.push_back(Nanoseconds(static_cast<double>(i) * 12.34567 + 0.5));
+    }
+    const sra::RuntimeProfile<Nanoseconds> profile(std::move(durations), std::move(sizes));
+
+    std::filesystem::create_directories("data");
+
+    std::cout << "=== Report Writer Benchmark ===\n\n";
+    std::cout << "Writing " << rows << " rows as CSV, JSON and text, best of " << runs << " runs\n\n";
+
+    const double stream_ms = best_of(runs, [&profile] { baseline::save_reports(profile, "data/bench_stream"); });
+    const double buffered_ms = best_of(runs, [&profile] { sra::save_reports(profile, "data/bench_buffered"); });
+
+    auto rows_per_second = [](double milliseconds) { return static_cast<double>(rows) * 1000.0 / milliseconds; };
+
+    std::cout << "   Stream writers:   " << stream_ms << " ms (" << rows_per_second(stream_ms) << " rows/s)\n";
+    std::cout << "   Buffered writers: " << buffered_ms << " ms (" << rows_per_second(buffered_ms) << " rows/s)\n";
+    std::cout << "   Speedup:          " << stream_ms / buffered_ms << "x\n";
+
+    return 0;
+}
@@ -0,0 +1,228 @@
+/**
+ * @file adaptive_sweep.hpp
+ * * @brief Cost-aware sample-size selection for runtime sweeps
+ *
+ * @project Simple Runtime Analyzer
+ *
+ * @author Diego Osorio (ShineKnightDev)
+ *
+ * @copyright Copyright (c) 2025 Diego Osorio (ShineKnightDev)
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <optional>
+#include <ranges>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "shineknightdev/runtime_analyzer.hpp"
+#include "shineknightdev/sample_utilities.hpp"
+
+namespace sra
+{
+
+struct AdaptiveSweepConfig
+{
+    size_t max_sample_size = 100000;
+    size_t initial_samples = 4; // Measured first, on the generate_sizes grid, smallest to largest
+    size_t max_samples = 30;
+    std::chrono::nanoseconds time_budget = std::chrono::seconds(60); // Wall time of the whole sweep
+    SampleSizeConfig size_config{}; // Smallest size and rounding of every size, bias of the initial grid
+};
+
+namespace detail
+{
+
+// One measured size of an adaptive sweep, in nanoseconds
+struct SweepPoint
+{
+    size_t size = 0;
+    double median_ns = 0.0;
+    double relative_ci = 0.0; // Half-width of the 95% CI of the mean relative to the mean, 0 without repetitions
+    double cost_ns = 0.0;     // Wall time spent generating and measuring the sample
+};
+
+// Log-log slope between two points, clamped so noisy tiny samples cannot produce absurd extrapolations.
+// Values below `floor_ns` count as `floor_ns`
+inline double log_slope(double size_a, double value_a, double size_b, double value_b, double floor_ns = 1.0) noexcept
+{
+    const double run = std::log(size_b / size_a);
+    if (run <= 0.0) return 1.0;
+    const double rise = std::log(std::max(value_b, floor_ns) / std::max(value_a, floor_ns));
+    return std::clamp(rise / run, 0.0, 4.0);
+}
+
+// Wall cost of measuring `size`, interpolated or extrapolated in log-log space from the measured points
+inline double predict_cost(const std::vector<SweepPoint>& points, size_t size) noexcept
+{
+    if (points.empty()) return 0.0;
+    if (points.size() == 1)
+    {
+        const auto& only = points.front();
+        return only.cost_ns * static_cast<double>(size) / static_cast<double>(only.size);
+    }
+
+    // Upper neighbor of `size`, or the last point when extrapolating past the largest size
+    auto upper = std::ranges::lower_bound(points, size, {}, &SweepPoint::size);
+    if (upper == points.begin()) { ++upper; }
+    if (upper == points.end()) { --upper; }
+    const auto& a = *(upper - 1);
+    const auto& b = *upper;
+
+    const double slope = log_slope(static_cast<double>(a.size), a.cost_ns, static_cast<double>(b.size), b.cost_ns);
+    return b.cost_ns * std::pow(static_cast<double>(size) / static_cast<double>(b.size), std::max(slope, 1.0));
+}
+
+// How much the interval between points i and i + 1 needs another size: wider intervals (in log space), a change of
+// the growth rate at either end and confidence intervals above the policy target all raise the score.
+// Medians below a microsecond are mostly timer noise, so the curve is treated as flat there
+inline double refinement_score(const std::vector<SweepPoint>& points, size_t i, double target_relative_ci) noexcept
+{
+    constexpr double curve_floor_ns = 1000.0;
+    auto slope = [&points](size_t k) {
+        return log_slope(static_cast<double>(points[k].size), points[k].median_ns,
+                         static_cast<double>(points[k + 1].size), points[k + 1].median_ns, curve_floor_ns);
+    };
+    auto bend = [&](size_t k) {
+        if (k == 0 || k + 1 >= points.size()) return 0.0;
+        return std::abs(slope(k) - slope(k - 1));
+    };
+    auto noise = [&](size_t k) {
+        if (target_relative_ci <= 0.0) return 0.0;
+        return std::max(points[k].relative_ci / target_relative_ci - 1.0, 0.0);
+    };
+
+    const double width = std::log(static_cast<double>(points[i + 1].size) / static_cast<double>(points[i].size));
+    return width * (1.0 + std::max(bend(i), bend(i + 1)) + std::max(noise(i), noise(i + 1)));
+}
+
+} // namespace detail
+
+// Sweeps sizes up to max_sample_size, choosing each next size from the measurements so far, until the time budget
+// or max_samples runs out. Samples are generated one at a time with `filler`; the profile is sorted by size
+template <typename T,
+          ChronoDuration Unit = std::chrono::milliseconds,
+          ClockPolicy Clock = SteadyClock,
+          detail::FillerFunction<T> F,
+          typename Func,
+          typename... Args>
+requires std::invocable<Func, const std::vector<T>&, Args...>
+[[nodiscard]] auto profile_adaptive(const MeasurementPolicy& policy,
+                                    const AdaptiveSweepConfig& config,
+                                    F&& filler,
+                                    Func&& func,
+                                    Args&&... args)
+{
+    const size_t min_sample_size = std::max<size_t>(config.size_config.round_to, 1);
+    if (config.max_sample_size < min_sample_size || config.initial_samples == 0 || config.max_samples == 0)
+    {
+        throw std::invalid_argument("Adaptive sweep requires a size range and at least one sample");
+    }
+    detail::validate_policy(policy);
+
+    // Measured in fractional nanoseconds so the curve analysis keeps full resolution, converted to Unit at the end
+    using Nanoseconds = Fractional<std::chrono::nanoseconds>;
+    std::vector<std::pair<size_t, SampleMeasurement<Nanoseconds>>> measurements;
+    std::vector<detail::SweepPoint> points;
+
+    auto probes = detail::open_probes(policy);
+
+    // Capture arguments safely
+    auto invoke_func = [&func, ... captured_args = std::forward<Args>(args)](const auto& sample) mutable {
+        detail::invoke_and_keep(func, sample, std::forward<Args>(captured_args)...);
+    };
+
+    const auto sweep_start = std::chrono::steady_clock::now();
+    auto spent_ns = [&sweep_start]() {
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - sweep_start).count();
+    };
+    const double budget_ns = std::chrono::duration<double, std::nano>(config.time_budget).count();
+
+    // Measures `size` if its predicted cost fits in the remaining budget. The first size is always measured
+    auto try_measure = [&](size_t size) {
+        if (!points.empty() && spent_ns() + detail::predict_cost(points, size) > budget_ns) return false;
+
+        const auto sample_start = std::chrono::steady_clock::now();
+        const auto samples = generate_samples<T>(filler, std::vector<size_t>{size});
+        const auto& sample = samples.front();
+
+        detail::SampleCalls<decltype(invoke_func), std::remove_cvref_t<decltype(sample)>> calls{invoke_func, sample};
+        auto measurement = detail::measure_sample<Nanoseconds, Clock>(policy, calls, &probes);
+        measurement.sample_size = sample.size();
+        measurement.throughput = detail::sample_throughput(policy, sample);
+
+        const auto& runs = measurement.repetitions;
+        detail::SweepPoint point;
+        point.size = size;
+        if (const auto& histogram = measurement.histogram)
+        {
+            const auto stats = detail::histogram_statistics<Nanoseconds>(*histogram, size);
+            const auto n = static_cast<double>(stats.repetitions);
+            point.median_ns = stats.median.count();
+            point.relative_ci = stats.repetitions > 1 && stats.mean.count() > 0.0
+                                    ? detail::student_t_975(stats.repetitions - 1) * stats.stddev.count() /
+                                          std::sqrt(n) / stats.mean.count()
+                                    : 0.0;
+        }
+        else
+        {
+            point.median_ns = detail::median_of<Nanoseconds>(runs).count();
+            point.relative_ci = runs.size() > 1 ? detail::relative_confidence_interval<Nanoseconds>(runs) : 0.0;
+        }
+        point.cost_ns =
+            std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - sample_start).count();
+
+        points.insert(std::ranges::upper_bound(points, size, {}, &detail::SweepPoint::size), point);
+        measurements.emplace_back(size, std::move(measurement));
+        return true;
+    };
+
+    auto initial_sizes = generate_sizes(config.initial_samples, config.max_sample_size, config.size_config);
+    if (initial_sizes.empty()) { initial_sizes.push_back(min_sample_size); }
+    for (const size_t size : initial_sizes)
+    {
+        if (points.size() >= config.max_samples || !try_measure(size)) { break; }
+    }
+
+    while (points.size() < config.max_samples && spent_ns() < budget_ns)
+    {
+        std::optional<size_t> next;
+        double best_score = 0.0;
+
+        for (size_t i = 0; i + 1 < points.size(); ++i)
+        {
+            // Geometric midpoint, so refinement is even on the log scale the curve is analyzed on
+            const double mid = std::sqrt(static_cast<double>(points[i].size) * static_cast<double>(points[i + 1].size));
+            const size_t size =
+                std::max(round_to(static_cast<size_t>(mid), config.size_config.round_to), min_sample_size);
+            if (size <= points[i].size || size >= points[i + 1].size) { continue; }
+            if (spent_ns() + detail::predict_cost(points, size) > budget_ns) { continue; }
+
+            const double score = detail::refinement_score(points, i, policy.target_relative_ci);
+            if (score > best_score)
+            {
+                best_score = score;
+                next = size;
+            }
+        }
+
+        if (!next || !try_measure(*next)) { break; }
+    }
+
+    std::ranges::sort(measurements, {}, &std::pair<size_t, SampleMeasurement<Nanoseconds>>::first);
+
+    RuntimeProfile<Nanoseconds> profile;
+    profile.reserve(measurements.size());
+    for (auto& [size, measurement] : measurements) { profile.append(std::move(measurement)); }
+
+    return RuntimeProfile<Unit>(profile);
+}
+
+} // namespace sra
@@ -0,0 +1,288 @@
+/**
+ * @file allocation_tracker.hpp
+ * * @brief Per-thread allocation tracking through replaceable operator new/delete
+ *
+ * @project Simple Runtime Analyzer
+ *
+ * @author Diego Osorio (ShineKnightDev)
+ *
+ * @copyright Copyright (c) 2025 Diego Osorio (ShineKnightDev)
+ * @license MIT License
+ *
+ * Define SRA_ALLOCATION_HOOKS in exactly one translation unit before including this header to install the
+ * global operator new/delete replacements. Without it, tracking is unavailable and costs nothing.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace sra
+{
+
+// Allocation activity of one sample. Count and bytes are per-call averages over the timed regions
+struct AllocationStats
+{
+    double allocations = 0.0;
+    double bytes_allocated = 0.0;
+    std::size_t peak_live_bytes = 0;
+};
+
+namespace detail
+{
+
+struct AllocationCounters
+{
+    bool active = false;
+    std::uint64_t allocations = 0;
+    std::uint64_t bytes_allocated = 0;
+    std::int64_t live_bytes = 0; // Relative to the start of the region, frees of older blocks make it negative
+    std::int64_t peak_live_bytes = 0;
+};
+
+inline thread_local AllocationCounters allocation_counters;
+inline bool allocation_hooks_installed = false;
+
+inline void record_allocation(std::size_t requested, std::size_t usable) noexcept
+{
+    auto& counters = allocation_counters;
+    if (!counters.active) return;
+
+    ++counters.allocations;
+    counters.bytes_allocated += requested;
+    counters.live_bytes += static_cast<std::int64_t>(usable);
+    counters.peak_live_bytes = std::max(counters.peak_live_bytes, counters.live_bytes);
+}
+
+inline void record_deallocation(std::size_t usable) noexcept
+{
+    auto& counters = allocation_counters;
+    if (!counters.active) return;
+
+    counters.live_bytes -= static_cast<std::int64_t>(usable);
+}
+
+inline void begin_allocation_region() noexcept
+{
+    allocation_counters = {};
+    allocation_counters.active = true;
+}
+
+inline void end_allocation_region() noexcept { allocation_counters.active = false; }
+
+// Sums the regions of one sample: counts and bytes add up, the peak keeps the highest region
+struct AllocationTotals
+{
+    std::uint64_t allocations = 0;
+    std::uint64_t bytes_allocated = 0;
+    std::int64_t peak_live_bytes = 0;
+
+    void add_region() noexcept
+    {
+        const auto& counters = allocation_counters;
+        allocations += counters.allocations;
+        bytes_allocated += counters.bytes_allocated;
+        peak_live_bytes = std::max(peak_live_bytes, counters.peak_live_bytes);
+    }
+
+    [[nodiscard]] AllocationStats take(std::size_t calls) noexcept
+    {
+        const double divisor = calls > 0 ? static_cast<double>(calls) : 1.0;
+        const AllocationStats stats{static_cast<double>(allocations) / divisor,
+                                    static_cast<double>(bytes_allocated) / divisor,
+                                    static_cast<std::size_t>(std::max<std::int64_t>(peak_live_bytes, 0))};
+        *this = {};
+        return stats;
+    }
+};
+
+} // namespace detail
+
+// True when this program was built with SRA_ALLOCATION_HOOKS in one translation unit
+[[nodiscard]] inline bool allocation_tracking_available() noexcept { return detail::allocation_hooks_installed; }
+
+// Tracks allocations made by the calling thread while alive. Scopes do not nest
+class AllocationScope
+{
+public:
+    AllocationScope() noexcept { detail::begin_allocation_region(); }
+
+    ~AllocationScope() { detail::end_allocation_region(); }
+
+    AllocationScope(const AllocationScope&) = delete;
+    AllocationScope& operator=(const AllocationScope&) = delete;
+
+    [[nodiscard]] AllocationStats stats() const noexcept
+    {
+        const auto& counters = detail::allocation_counters;
+        return {static_cast<double>(counters.allocations),
+                static_cast<double>(counters.bytes_allocated),
+                static_cast<std::size_t>(std::max<std::int64_t>(counters.peak_live_bytes, 0))};
+    }
+};
+
+} // namespace sra
+
+#if defined(SRA_ALLOCATION_HOOKS) && !defined(SRA_ALLOCATION_HOOKS_DEFINED)
+#    define SRA_ALLOCATION_HOOKS_DEFINED
+
+#    include <cstdlib>
+#    include <new>
+
+#    if defined(_WIN32)
+#        include <malloc.h>
+#    elif defined(__APPLE__)
+#        include <malloc/malloc.h>
+#    else
+#        include <malloc.h>
+#    endif
+
+// The replacement operators forward to malloc/free, which GCC flags once they are inlined into new/delete pairs
+#    if defined(__GNUC__) && !defined(__clang__)
+#        pragma GCC diagnostic push
+#        pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#    endif
+
+namespace sra::detail
+{
+
+inline std::size_t usable_size(void* ptr) noexcept
+{
+#    if defined(_WIN32)
+    return _msize(ptr);
+#    elif defined(__APPLE__)
+    return malloc_size(ptr);
+#    else
+    return malloc_usable_size(ptr);
+#    endif
+}
+
+// Outside a tracked region the hooks only forward to the allocator, the usable size is looked up inside one
+[[nodiscard]] inline bool allocation_region_active() noexcept { return allocation_counters.active; }
+
+inline void* tracked_allocate(std::size_t size) noexcept
+{
+    void* ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr && allocation_region_active()) { record_allocation(size, usable_size(ptr)); }
+    return ptr;
+}
+
+inline void* tracked_allocate_aligned(std::size_t size, std::align_val_t alignment) noexcept
+{
+    const auto align = std::max(static_cast<std::size_t>(alignment), sizeof(void*));
+#    if defined(_WIN32)
+    void* ptr = _aligned_malloc(size == 0 ? 1 : size, align);
+    if (ptr && allocation_region_active()) { record_allocation(size, _aligned_msize(ptr, align, 0)); }
+#    else
+    void* ptr = nullptr;
+    if (posix_memalign(&ptr, align, size == 0 ? 1 : size) != 0) { ptr = nullptr; }
+    if (ptr && allocation_region_active()) { record_allocation(size, usable_size(ptr)); }
+#    endif
+    return ptr;
+}
+
+inline void tracked_free(void* ptr) noexcept
+{
+    if (!ptr) return;
+    if (allocation_region_active()) { record_deallocation(usable_size(ptr)); }
+    std::free(ptr);
+}
+
+inline void tracked_free_aligned(void* ptr, [[maybe_unused]] std::align_val_t alignment) noexcept
+{
+    if (!ptr) return;
+#    if defined(_WIN32)
+    const auto align = std::max(static_cast<std::size_t>(alignment), sizeof(void*));
+    if (allocation_region_active()) { record_deallocation(_aligned_msize(ptr, align, 0)); }
+    _aligned_free(ptr);
+#    else
+    if (allocation_region_active()) { record_deallocation(usable_size(ptr)); }
+    std::free(ptr);
+#    endif
+}
+
+inline const bool allocation_hooks_registered = (allocation_hooks_installed = true);
+
+} // namespace sra::detail
+
+void* operator new(std::size_t size)
+{
+    if (void* ptr = sra::detail::tracked_allocate(size)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    if (void* ptr = sra::detail::tracked_allocate(size)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return sra::detail::tracked_allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return sra::detail::tracked_allocate(size); }
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    if (void* ptr = sra::detail::tracked_allocate_aligned(size, alignment)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    if (void* ptr = sra::detail::tracked_allocate_aligned(size, alignment)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return sra::detail::tracked_allocate_aligned(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return sra::detail::tracked_allocate_aligned(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept { sra::detail::tracked_free(ptr); }
+void operator delete[](void* ptr) noexcept { sra::detail::tracked_free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { sra::detail::tracked_free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { sra::detail::tracked_free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { sra::detail::tracked_free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { sra::detail::tracked_free(ptr); }
+
+void operator delete(void* ptr, std::align_val_t alignment) noexcept
+{
+    sra::detail::tracked_free_aligned(ptr, alignment);
+}
+
+void operator delete[](void* ptr, std::align_val_t alignment) noexcept
+{
+    sra::detail::tracked_free_aligned(ptr, alignment);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t alignment) noexcept
+{
+    sra::detail::tracked_free_aligned(ptr, alignment);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t alignment) noexcept
+{
+    sra::detail::tracked_free_aligned(ptr, alignment);
+}
+
+void operator delete(void* ptr, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    sra::detail::tracked_free_aligned(ptr, alignment);
+}
+
+void operator delete[](void* ptr, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    sra::detail::tracked_free_aligned(ptr, alignment);
+}
+
+#    if defined(__GNUC__) && !defined(__clang__)
+#        pragma GCC diagnostic pop
+#    endif
+
+#endif
@@ -0,0 +1,162 @@
+/**
+ * @file bandwidth_probe.hpp
+ * * @brief STREAM-style memory bandwidth probe for reporting throughput as a fraction of peak
+ *
+ * @project Simple Runtime Analyzer
+ *
+ * @author Diego Osorio (ShineKnightDev)
+ *
+ * @copyright Copyright (c) 2025 Diego Osorio (ShineKnightDev)
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <barrier>
+#include <chrono>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "shineknightdev/cache_control.hpp"
+#include "shineknightdev/runtime_analyzer.hpp"
+
+namespace sra
+{
+
+struct BandwidthConfig
+{
+    size_t array_bytes = 0;  // Bytes of each of the three arrays, 0 for four times last_level_cache_bytes()
+    size_t threads = 1;      // 0 uses one thread per available core
+    size_t repetitions = 10; // Timed passes of each kernel, after one untimed pass
+};
+
+// Best sustained bandwidth of each STREAM kernel over the repetitions, in bytes per second
+struct StreamBandwidth
+{
+    double copy = 0.0;  // c = a
+    double scale = 0.0; // b = q * c
+    double add = 0.0;   // c = a + b
+    double triad = 0.0; // a = b + q * c
+
+    [[nodiscard]] double peak() const noexcept { return std::max({copy, scale, add, triad}); }
+};
+
+namespace detail
+{
+
+enum class StreamKernel
+{
+    copy,
+    scale,
+    add,
+    triad
+};
+
+inline constexpr std::array<StreamKernel, 4> stream_kernels = {
+    StreamKernel::copy, StreamKernel::scale, StreamKernel::add, StreamKernel::triad};
+
+// Arrays each kernel reads and writes, as STREAM counts them
+[[nodiscard]] constexpr size_t stream_arrays_touched(StreamKernel kernel) noexcept
+{
+    return kernel == StreamKernel::copy || kernel == StreamKernel::scale ? 2 : 3;
+}
+
+inline void run_stream_kernel(StreamKernel kernel, double* a, double* b, double* c, size_t begin, size_t end) noexcept
+{
+    constexpr double q = 3.0;
+    switch (kernel)
+    {
+        case StreamKernel::copy:
+            for (size_t i = begin; i < end; ++i) { c[i] = a[i]; }
+            break;
+        case StreamKernel::scale:
+            for (size_t i = begin; i < end; ++i) { b[i] = q * c[i]; }
+            break;
+        case StreamKernel::add:
+            for (size_t i = begin; i < end; ++i) { c[i] = a[i] + b[i]; }
+            break;
+        case StreamKernel::triad:
+            for (size_t i = begin; i < end; ++i) { a[i] = b[i] + q * c[i]; }
+            break;
+    }
+    clobber_memory();
+}
+
+} // namespace detail
+
+// Measures the sustainable memory bandwidth with the copy, scale, add and triad kernels of the STREAM benchmark.
+// Each thread first touches and then sweeps its own slice of the arrays, and a pass is timed from the barrier all
+// threads leave together to the barrier they all reach. Compare single-threaded benchmarks with a single thread
+[[nodiscard]] inline StreamBandwidth measure_stream_bandwidth(const BandwidthConfig& config = {})
+{
+    if (config.repetitions == 0) { throw std::invalid_argument("Bandwidth probe requires at least one repetition"); }
+
+    const size_t array_bytes = config.array_bytes != 0 ? config.array_bytes : 4 * last_level_cache_bytes();
+    const size_t length = array_bytes / sizeof(double);
+    const size_t threads = std::max<size_t>(
+        config.threads != 0 ? config.threads : std::thread::hardware_concurrency(), 1);
+    if (length < threads)
+    {
+        throw std::invalid_argument("Bandwidth probe arrays are smaller than one element per thread");
+    }
+
+    // Left uninitialized so each thread touches its own slice first, which places it on its NUMA node
+    const std::unique_ptr<double[]> a(new double[length]);
+    const std::unique_ptr<double[]> b(new double[length]);
+    const std::unique_ptr<double[]> c(new double[length]);
+
+    std::array<double, detail::stream_kernels.size()> best_ns;
+    best_ns.fill(std::numeric_limits<double>::infinity());
+    std::chrono::steady_clock::time_point start;
+    std::barrier sync(static_cast<std::ptrdiff_t>(threads));
+
+    auto worker = [&](size_t index) {
+        const size_t begin = length * index / threads;
+        const size_t end = length * (index + 1) / threads;
+        std::fill(a.get() + begin, a.get() + end, 1.0);
+        std::fill(b.get() + begin, b.get() + end, 2.0);
+        std::fill(c.get() + begin, c.get() + end, 0.0);
+
+        for (size_t pass = 0; pass <= config.repetitions; ++pass)
+        {
+            for (size_t k = 0; k < detail::stream_kernels.size(); ++k)
+            {
+                sync.arrive_and_wait();
+                if (index == 0) { start = std::chrono::steady_clock::now(); }
+                detail::run_stream_kernel(detail::stream_kernels[k], a.get(), b.get(), c.get(), begin, end);
+                sync.arrive_and_wait();
+
+                // The first pass only brings the arrays into memory and the kernels into the instruction cache
+                if (index == 0 && pass > 0)
+                {
+                    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+                    best_ns[k] = std::min(best_ns[k], elapsed.count());
+                }
+            }
+        }
+    };
+
+    {
+        std::vector<std::jthread> pool;
+        pool.reserve(threads - 1);
+        for (size_t index = 1; index < threads; ++index) { pool.emplace_back(worker, index); }
+        worker(0);
+    }
+
+    std::array<double, detail::stream_kernels.size()> bandwidth{};
+    for (size_t k = 0; k < detail::stream_kernels.size(); ++k)
+    {
+        const auto bytes = static_cast<double>(detail::stream_arrays_touched(detail::stream_kernels[k]) * length *
+                                               sizeof(double));
+        bandwidth[k] = best_ns[k] > 0.0 ? bytes / best_ns[k] * 1e9 : 0.0;
+    }
+    return {.copy = bandwidth[0], .scale = bandwidth[1], .add = bandwidth[2], .triad = bandwidth[3]};
+}
+
+} // namespace sra
@@ -0,0 +1,369 @@
+/**
+ * @file benchmark_registry.hpp
+ * * @brief Benchmark registration macro and a command-line runner for registered benchmarks
+ *
+ * @project Simple Runtime Analyzer
+ *
+ * @author Diego Osorio (ShineKnightDev)
+ *
+ * @copyright Copyright (c) 2025 Diego Osorio (ShineKnightDev)
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <optional>
+#include <ostream>
+#include <regex>
+#include <set>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "shineknightdev/parallel_profiler.hpp"
+#include "shineknightdev/runtime_analyzer.hpp"
+#include "shineknightdev/runtime_reporter.hpp"
+
+namespace sra
+{
+
+// A registered benchmark. Samples are generated when it runs, so benchmarks left out by a filter cost nothing
+struct Benchmark
+{
+    using Nanoseconds = Fractional<std::chrono::nanoseconds>;
+
+    std::string name;
+    MeasurementPolicy policy;
+
+    // Measures every sample with `policy`, on `threads` workers when above 1 (0 uses one worker per core)
+    std::function<RuntimeProfile<Nanoseconds>(const MeasurementPolicy& policy, size_t threads)> run;
+};
+
+// Benchmarks registered so far, in registration order
+[[nodiscard]] inline std::vector<Benchmark>& benchmark_registry()
+{
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+// Registers `func` measured over the samples returned by `generate()`. `func` is anything profile_runtime accepts,
+// a callable taking a sample or a Fixture. Returns true, so it can initialize a static variable
+template <typename Func, typename Generate>
+requires std::invocable<Generate&> && std::ranges::random_access_range<std::invoke_result_t<Generate&>> &&
+         std::ranges::sized_range<std::invoke_result_t<Generate&>>
+bool register_benchmark(std::string name, Func func, Generate generate, const MeasurementPolicy& policy = {})
+{
+    using Nanoseconds = Benchmark::Nanoseconds;
+
+    auto run = [func = std::move(func), generate = std::move(generate)](const MeasurementPolicy& run_policy,
+                                                                       size_t threads) mutable {
+        const auto samples = generate();
+        if (threads == 1) { return profile_runtime<Nanoseconds>(run_policy, func, samples); }
+        return profile_runtime_parallel<Nanoseconds>(run_policy, ParallelConfig{.threads = threads}, func, samples);
+    };
+    benchmark_registry().push_back({std::move(name), policy, std::move(run)});
+    return true;
+}
+
+// Options of the benchmark runner, parsed from its command line
+struct BenchmarkOptions
+{
+    std::string filter;  // Regex searched in benchmark names, empty runs every benchmark
+    std::string exclude; // Regex of benchmark names to skip, empty skips none
+    std::optional<size_t> repetitions;
+    std::optional<size_t> warmup_runs;
+    std::string unit = "ms";        // ns, us, ms or s
+    std::string format = "text";    // text, csv, json, trace or srp
+    std::filesystem::path output{}; // Directory for one report per benchmark, empty writes to standard output
+    size_t threads = 1;             // 1 measures sequentially, 0 uses one worker per core
+    bool list_only = false;
+    bool help = false;
+};
+
+inline constexpr std::string_view benchmark_options =
+    "  --filter=REGEX       Run the benchmarks whose name contains a match of REGEX\n"
+    "  --exclude=REGEX      Skip the benchmarks whose name contains a match of REGEX\n"
+    "  --repetitions=N      Timed repetitions per sample, overriding the policy of each benchmark\n"
+    "  --warmup=N           Untimed runs per sample, overriding the policy of each benchmark\n"
+    "  --unit=UNIT          Time unit of the reports: ns, us, ms or s (default ms)\n"
+    "  --format=FORMAT      Report format: text, csv, json, trace or srp (default text)\n"
+    "  --output=DIR         Save one report per benchmark in DIR instead of writing to standard output\n"
+    "  --threads=N          Measure the samples of each benchmark on N workers, 0 for one per core (default 1)\n"
+    "  --list               List the selected benchmarks without running them\n"
+    "  --help               Show this message\n";
+
+namespace detail
+{
+
+inline void print_benchmark_usage(std::ostream& out, std::string_view program)
+{
+    out << "Usage: " << program << " [options]\n" << benchmark_options;
+}
+
+[[nodiscard]] inline size_t parse_count_option(std::string_view option, std::string_view value)
+{
+    size_t count = 0;
+    const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), count);
+    if (error != std::errc{} || end != value.data() + value.size())
+    {
+        throw std::invalid_argument("Option " + std::string(option) + " expects a number, got '" + std::string(value) +
+                                    "'");
+    }
+    return count;
+}
+
+// Keeps the characters that are safe in a file name
+[[nodiscard]] inline std::string benchmark_file_stem(std::string_view name)
+{
+    std::string stem(name);
+    for (auto& c : stem)
+    {
+        const bool safe = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' ||
+                          c == '_' || c == '.';
+        if (!safe) { c = '_'; }
+    }
+    return stem;
+}
+
+// Calls `emit` with the profile converted to the unit named on the command line
+template <typename Emit>
+void with_report_unit(std::string_view unit, const RuntimeProfile<Benchmark::Nanoseconds>& profile, Emit&& emit)
+{
+    if (unit == "ns") { emit(profile); }
+    else if (unit == "us") { emit(profile.convert_to<Fractional<std::chrono::microseconds>>()); }
+    else if (unit == "ms") { emit(profile.convert_to<Fractional<std::chrono::milliseconds>>()); }
+    else { emit(profile.convert_to<Fractional<std::chrono::seconds>>()); }
+}
+
+} // namespace detail
+
+// Parses `--option=value` and `--option value` arguments, without the program name. Throws std::invalid_argument
+[[nodiscard]] inline BenchmarkOptions parse_benchmark_options(std::span<const std::string_view> arguments)
+{
+    BenchmarkOptions options;
+    for (size_t i = 0; i < arguments.size(); ++i)
+    {
+        std::string_view option = arguments[i];
+        std::optional<std::string_view> inline_value;
+        if (const auto equals = option.find('='); equals != std::string_view::npos)
+        {
+            inline_value = option.substr(equals + 1);
+            option = option.substr(0, equals);
+        }
+
+        if (option == "--list")
+        {
+            options.list_only = true;
+            continue;
+        }
+        if (option == "--help" || option == "-h")
+        {
+            options.help = true;
+            continue;
+        }
+
+        auto value = [&]() -> std::string_view {
+            if (inline_value) { return *inline_value; }
+            if (i + 1 >= arguments.size())
+            {
+                throw std::invalid_argument("Option " + std::string(option) + " expects a value");
+            }
+            return arguments[++i];
+        };
+
+        if (option == "--filter") { options.filter = value(); }
+        else if (option == "--exclude") { options.exclude = value(); }
+        else if (option == "--repetitions") { options.repetitions = detail::parse_count_option(option, value()); }
+        else if (option == "--warmup") { options.warmup_runs = detail::parse_count_option(option, value()); }
+        else if (option == "--threads") { options.threads = detail::parse_count_option(option, value()); }
+        else if (option == "--output") { options.output = value(); }
+        else if (option == "--unit")
+        {
+            options.unit = value();
+            if (options.unit != "ns" && options.unit != "us" && options.unit != "ms" && options.unit != "s")
+            {
+                throw std::invalid_argument("Unknown time unit '" + options.unit + "', expected ns, us, ms or s");
+            }
+        }
+        else if (option == "--format")
+        {
+            options.format = value();
+            const std::set<std::string, std::less<>> formats = {"text", "csv", "json", "trace", "srp"};
+            if (!formats.contains(options.format))
+            {
+                throw std::invalid_argument("Unknown report format '" + options.format +
+                                            "', expected text, csv, json, trace or srp");
+            }
+        }
+        else { throw std::invalid_argument("Unknown option " + std::string(arguments[i])); }
+    }
+
+    if (options.output.empty() && options.format != "text" && options.format != "json")
+    {
+        throw std::invalid_argument("Format " + options.format + " needs --output, standard output takes text or json");
+    }
+    return options;
+}
+
+// Registered benchmarks whose names pass the filters of `options`. Throws std::regex_error on an invalid regex
+[[nodiscard]] inline std::vector<const Benchmark*> select_benchmarks(const BenchmarkOptions& options)
+{
+    const std::regex filter(options.filter);
+    const std::optional<std::regex> exclude =
+        options.exclude.empty() ? std::nullopt : std::optional<std::regex>(std::regex(options.exclude));
+
+    std::vector<const Benchmark*> selected;
+    for (const auto& benchmark : benchmark_registry())
+    {
+        if (!std::regex_search(benchmark.name, filter)) { continue; }
+        if (exclude && std::regex_search(benchmark.name, *exclude)) { continue; }
+        selected.push_back(&benchmark);
+    }
+    return selected;
+}
+
+// Runs the selected benchmarks and writes their reports. Progress and errors go to std::cerr, so standard output only
+// holds reports. Returns 0 when every benchmark ran, 1 when one failed or none matched the filters
+inline int run_benchmarks(const BenchmarkOptions& options, std::ostream& out = std::cout)
+{
+    std::set<std::string_view> names;
+    for (const auto& benchmark : benchmark_registry())
+    {
+        if (!names.insert(benchmark.name).second)
+        {
+            std::cerr << "Error: benchmark " << benchmark.name << " is registered more than once\n";
+            return 1;
+        }
+    }
+
+    const auto selected = select_benchmarks(options);
+    if (options.list_only)
+    {
+        for (const auto* benchmark : selected) { out << benchmark->name << "\n"; }
+        return 0;
+    }
+    if (selected.empty())
+    {
+        std::cerr << "Error: no benchmark matches the filters\n";
+        return 1;
+    }
+    if (!options.output.empty()) { std::filesystem::create_directories(options.output); }
+
+    // Standard output holds one JSON document, with each report under the name of its benchmark
+    const bool json_to_stdout = options.output.empty() && options.format == "json";
+    if (json_to_stdout) { out << "{\"benchmarks\": ["; }
+
+    int status = 0;
+    bool first = true;
+    for (const auto* benchmark : selected)
+    {
+        auto policy = benchmark->policy;
+        if (options.repetitions) { policy.repetitions = *options.repetitions; }
+        if (options.warmup_runs) { policy.warmup_runs = *options.warmup_runs; }
+
+        std::cerr << "Running " << benchmark->name << "...\n";
+        try
+        {
+            const auto profile = benchmark->run(policy, options.threads);
+            detail::with_report_unit(options.unit, profile, [&](const auto& report) {
+                if (!options.output.empty())
+                {
+                    const auto stem = detail::benchmark_file_stem(benchmark->name);
+                    const auto extension = options.format == "text" ? std::string(".txt") : "." + options.format;
+                    save_report(report, options.output / (stem + extension));
+                }
+                else if (json_to_stdout)
+                {
+                    out << (first ? "\n" : ",\n") << "{\"name\": \"" << detail::escape_json(benchmark->name)
+                        << "\", \"report\": ";
+                    generate_report(out, report, "json");
+                    out << "}";
+                }
+                else
+                {
+                    out << "Benchmark: " << benchmark->name << "\n";
+                    generate_report(out, report, "text");
+                    out << "\n";
+                }
+            });
+            first = false;
+        }
+        catch (const std::exception& error)
+        {
+            std::cerr << "Error: benchmark " << benchmark->name << " failed: " << error.what() << "\n";
+            status = 1;
+        }
+    }
+
+    if (json_to_stdout) { out << "\n]}\n"; }
+    return status;
+}
+
+// Entry point of a benchmark binary: parses the command line, then lists or runs the registered benchmarks
+inline int run_benchmarks(int argc, char** argv)
+{
+    const std::string_view program = argc > 0 && argv[0] != nullptr ? argv[0] : "benchmarks";
+    const std::vector<std::string_view> arguments(argv + std::min(argc, 1), argv + argc);
+    try
+    {
+        const auto options = parse_benchmark_options(arguments);
+        if (options.help)
+        {
+            detail::print_benchmark_usage(std::cout, program);
+            return 0;
+        }
+        return run_benchmarks(options);
+    }
+    catch (const std::invalid_argument& error)
+    {
+        std::cerr << "Error: " << error.what() << "\n";
+        detail::print_benchmark_usage(std::cerr, program);
+        return 2;
+    }
+    catch (const std::regex_error& error)
+    {
+        std::cerr << "Error: invalid benchmark name regex (" << error.what() << ")\n";
+        return 2;
+    }
+    catch (const std::exception& error)
+    {
+        // E.g. an --output directory that cannot be created
+        std::cerr << "Error: " << error.what() << "\n";
+        return 1;
+    }
+}
+
+} // namespace sra
+
+#define SRA_BENCHMARK_CONCAT_IMPL(a, b) a##b
+#define SRA_BENCHMARK_CONCAT(a, b) SRA_BENCHMARK_CONCAT_IMPL(a, b)
+
+// Unique per use in a translation unit, so registrations on one line, e.g. from another macro, do not collide
+#ifdef __COUNTER__
+#    define SRA_BENCHMARK_UNIQUE_ID __COUNTER__
+#else
+#    define SRA_BENCHMARK_UNIQUE_ID __LINE__
+#endif
+
+// Registers a benchmark at static initialization: SRA_BENCHMARK("sort/intro", func, sample_gen[, policy])
+#define SRA_BENCHMARK(name, func, ...)                                                                                \
+    static const bool SRA_BENCHMARK_CONCAT(sra_benchmark_, SRA_BENCHMARK_UNIQUE_ID) =                                 \
+        ::sra::register_benchmark(name, func, __VA_ARGS__)
+
+// Defines main() as the benchmark runner, in one source file of a benchmark binary
+#define SRA_BENCHMARK_MAIN()                                                                                          \
+    int main(int argc, char** argv)                                                                                    \
+    {                                                                                                                  \
+        return ::sra::run_benchmarks(argc, argv);                                                                      \
+    }
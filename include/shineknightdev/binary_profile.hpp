@@ -0,0 +1,680 @@
+/**
+ * @file binary_profile.hpp
+ * * @brief Columnar binary format for runtime profiles
+ *
+ * @project Simple Runtime Analyzer
+ *
+ * @author Diego Osorio (ShineKnightDev)
+ *
+ * @copyright Copyright (c) 2025 Diego Osorio (ShineKnightDev)
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <limits>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "shineknightdev/runtime_analyzer.hpp"
+#include "shineknightdev/sample_archive.hpp"
+
+namespace sra
+{
+
+namespace detail
+{
+
+// Layout: header, column_count descriptors, metadata_size bytes of "key=value" lines, then the columns, each
+// starting on a 64-byte boundary. Every column is a contiguous array of 8-byte values
+struct ProfileHeader
+{
+    std::array<char, 8> magic{};
+    std::uint32_t version = 0;
+    std::uint32_t byte_order = 0; // Written as 0x01020304 in the writer's byte order
+    std::uint64_t sample_count = 0;
+    std::uint32_t column_count = 0;
+    std::uint32_t metadata_size = 0;
+    std::int64_t period_num = 1; // Period of the time columns in seconds, as a ratio
+    std::int64_t period_den = 1;
+    std::array<char, 16> unit_symbol{}; // UTF-8, padded with zeros
+};
+
+enum class ColumnType : std::uint32_t
+{
+    float64 = 1,
+    uint64 = 2,
+    int64 = 3
+};
+
+struct ColumnDescriptor
+{
+    std::array<char, 40> name{}; // Padded with zeros
+    ColumnType type = ColumnType::float64;
+    std::uint32_t reserved = 0;
+    std::uint64_t offset = 0; // From the start of the file
+    std::uint64_t count = 0;  // Values, sample_count except for the repetition columns
+};
+
+static_assert(sizeof(ProfileHeader) == 64 && std::is_trivially_copyable_v<ProfileHeader>);
+static_assert(sizeof(ColumnDescriptor) == 64 && std::is_trivially_copyable_v<ColumnDescriptor>);
+
+inline constexpr std::array<char, 8> profile_magic = {'S', 'R', 'A', 'P', 'R', 'O', 'F', '\0'};
+inline constexpr std::uint32_t profile_version = 1;
+
+template <typename T>
+[[nodiscard]] constexpr ColumnType column_type() noexcept
+{
+    if constexpr (std::is_floating_point_v<T>) { return ColumnType::float64; }
+    else if constexpr (std::is_signed_v<T>) { return ColumnType::int64; }
+    else { return ColumnType::uint64; }
+}
+
+// Time columns keep the representation of the unit: float64 for Fractional units, int64 otherwise
+template <ChronoDuration Unit>
+using StoredTime = std::conditional_t<std::is_floating_point_v<typename Unit::rep>, double, std::int64_t>;
+
+struct ColumnData
+{
+    ColumnDescriptor descriptor;
+    std::vector<std::byte> bytes;
+};
+
+class ColumnWriter
+{
+public:
+    template <typename T>
+    requires(sizeof(T) == 8)
+    void add(std::string_view name, std::span<const T> values)
+    {
+        ColumnData column;
+        std::ranges::copy(name.substr(0, column.descriptor.name.size() - 1), column.descriptor.name.begin());
+        column.descriptor.type = column_type<T>();
+        column.descriptor.count = values.size();
+        const auto bytes = std::as_bytes(values);
+        column.bytes.assign(bytes.begin(), bytes.end());
+        columns.push_back(std::move(column));
+    }
+
+    void add_metadata(std::string_view key, std::string_view value)
+    {
+        metadata += key;
+        metadata += '=';
+        metadata += value;
+        metadata += '\n';
+    }
+
+    void write(std::ostream& out, ProfileHeader header)
+    {
+        header.column_count = static_cast<std::uint32_t>(columns.size());
+        header.metadata_size = static_cast<std::uint32_t>(metadata.size());
+
+        std::uint64_t offset = sizeof(header) + columns.size() * sizeof(ColumnDescriptor) + metadata.size();
+        for (auto& column : columns)
+        {
+            offset = align_up(offset, 64);
+            column.descriptor.offset = offset;
+            offset += column.bytes.size();
+        }
+
+        std::uint64_t position = 0;
+        auto write_bytes = [&out, &position](const void* data, size_t size) {
+            out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+            position += size;
+        };
+        auto pad_to = [&write_bytes, &position](std::uint64_t target) {
+            static constexpr std::array<char, 64> zeros{};
+            write_bytes(zeros.data(), target - position);
+        };
+
+        write_bytes(&header, sizeof(header));
+        for (const auto& column : columns) { write_bytes(&column.descriptor, sizeof(column.descriptor)); }
+        write_bytes(metadata.data(), metadata.size());
+        for (const auto& column : columns)
+        {
+            pad_to(column.descriptor.offset);
+            write_bytes(column.bytes.data(), column.bytes.size());
+        }
+    }
+
+private:
+    std::vector<ColumnData> columns;
+    std::string metadata;
+};
+
+[[nodiscard]] inline std::optional<ComplexityClass> parse_complexity_class(std::string_view name)
+{
+    for (auto complexity = ComplexityClass::constant; complexity <= ComplexityClass::power_law;
+         complexity = static_cast<ComplexityClass>(static_cast<int>(complexity) + 1))
+    {
+        if (to_string(complexity) == name) return complexity;
+    }
+    return std::nullopt;
+}
+
+template <ChronoDuration Unit>
+void write_binary_report_impl(std::ostream& out, const RuntimeProfile<Unit>& profile)
+{
+    using Time = StoredTime<Unit>;
+    constexpr double missing = std::numeric_limits<double>::quiet_NaN();
+
+    ColumnWriter writer;
+
+    const std::vector<std::uint64_t> sizes(profile.sample_sizes.begin(), profile.sample_sizes.end());
+    writer.add<std::uint64_t>("sample_size", sizes);
+
+    std::vector<Time> times;
+    times.reserve(profile.size());
+    for (const auto& duration : profile.raw_durations) { times.push_back(static_cast<Time>(duration.count())); }
+    writer.add<Time>("time_value", times);
+
+    // Repetitions of sample i are repetitions[repetition_offsets[i], repetition_offsets[i + 1])
+    std::vector<std::uint64_t> offsets = {0};
+    std::vector<Time> repetitions;
+    for (const auto& runs : profile.repetitions)
+    {
+        for (const auto& run : runs) { repetitions.push_back(static_cast<Time>(run.count())); }
+        offsets.push_back(repetitions.size());
+    }
+    writer.add<std::uint64_t>("repetition_offsets", offsets);
+    writer.add<Time>("repetitions", repetitions);
+
+    // Histograms keep only their non-empty buckets, sample i owns entries [histogram_offsets[i], [i + 1])
+    if (!profile.histograms.empty())
+    {
+        std::vector<std::uint64_t> histogram_offsets = {0}, buckets, counts, minimums, maximums, sums;
+        for (const auto& histogram : profile.histograms)
+        {
+            for (size_t b = 0; b < histogram.bucket_count(); ++b)
+            {
+                if (const auto n = histogram.count_at(b))
+                {
+                    buckets.push_back(b);
+                    counts.push_back(n);
+                }
+            }
+            histogram_offsets.push_back(buckets.size());
+            minimums.push_back(histogram.min());
+            maximums.push_back(histogram.max());
+            sums.push_back(histogram.sum());
+        }
+        writer.add<std::uint64_t>("histogram_offsets", histogram_offsets);
+        writer.add<std::uint64_t>("histogram_buckets", buckets);
+        writer.add<std::uint64_t>("histogram_counts", counts);
+        writer.add<std::uint64_t>("histogram_min", minimums);
+        writer.add<std::uint64_t>("histogram_max", maximums);
+        writer.add<std::uint64_t>("histogram_sum", sums);
+        writer.add_metadata("histogram_precision", std::to_string(profile.histograms.front().precision_bits()));
+    }
+
+    if (!profile.counters.empty())
+    {
+        for (const auto& field : counter_fields)
+        {
+            std::vector<double> values;
+            values.reserve(profile.counters.size());
+            for (const auto& counters : profile.counters)
+            {
+                values.push_back((counters.*field.member).value_or(missing));
+            }
+            writer.add<double>(field.name, values);
+        }
+    }
+
+    if (!profile.allocations.empty())
+    {
+        std::vector<double> allocations, bytes_allocated;
+        std::vector<std::uint64_t> peak_live_bytes;
+        for (const auto& stats : profile.allocations)
+        {
+            allocations.push_back(stats.allocations);
+            bytes_allocated.push_back(stats.bytes_allocated);
+            peak_live_bytes.push_back(stats.peak_live_bytes);
+        }
+        writer.add<double>("allocations", allocations);
+        writer.add<double>("bytes_allocated", bytes_allocated);
+        writer.add<std::uint64_t>("peak_live_bytes", peak_live_bytes);
+    }
+
+    if (!profile.cpu_ids.empty())
+    {
+        const std::vector<std::int64_t> cpu_ids(profile.cpu_ids.begin(), profile.cpu_ids.end());
+        writer.add<std::int64_t>("cpu_id", cpu_ids);
+    }
+
+    if (!profile.process_usage.empty())
+    {
+        std::vector<std::uint64_t> max_rss_bytes, voluntary_switches, involuntary_switches;
+        for (const auto& usage : profile.process_usage)
+        {
+            max_rss_bytes.push_back(usage.max_rss_bytes);
+            voluntary_switches.push_back(usage.voluntary_switches);
+            involuntary_switches.push_back(usage.involuntary_switches);
+        }
+        writer.add<std::uint64_t>("max_rss_bytes", max_rss_bytes);
+        writer.add<std::uint64_t>("voluntary_switches", voluntary_switches);
+        writer.add<std::uint64_t>("involuntary_switches", involuntary_switches);
+    }
+
+    if (!profile.cache_modes.empty())
+    {
+        std::vector<std::int64_t> cache_modes;
+        for (const auto mode : profile.cache_modes) { cache_modes.push_back(static_cast<std::int64_t>(mode)); }
+        writer.add<std::int64_t>("cache_mode", cache_modes);
+    }
+
+    if (!profile.throughput.empty())
+    {
+        std::vector<std::uint64_t> items, bytes;
+        for (const auto& throughput : profile.throughput)
+        {
+            items.push_back(throughput.items);
+            bytes.push_back(throughput.bytes);
+        }
+        writer.add<std::uint64_t>("items", items);
+        writer.add<std::uint64_t>("bytes", bytes);
+    }
+    if (profile.peak_bandwidth)
+    {
+        writer.add_metadata("peak_bandwidth", std::format("{:.17g}", *profile.peak_bandwidth));
+    }
+
+    // Fits are stored in full precision, residuals are recomputed from the samples when loading
+    if (profile.complexity)
+    {
+        writer.add_metadata("complexity_best", to_string(profile.complexity->best_fit().complexity));
+        for (const auto& fit : profile.complexity->fits)
+        {
+            writer.add_metadata("complexity_fit",
+                                std::format("{};{:.17g};{:.17g};{:.17g};{:.17g}", to_string(fit.complexity),
+                                            fit.intercept, fit.coefficient, fit.exponent, fit.r_squared));
+        }
+    }
+
+    ProfileHeader header;
+    header.magic = profile_magic;
+    header.version = profile_version;
+    header.byte_order = archive_byte_order;
+    header.sample_count = profile.size();
+    header.period_num = Unit::period::num;
+    header.period_den = Unit::period::den;
+    std::ranges::copy(std::string_view(profile.unit_symbol).substr(0, header.unit_symbol.size() - 1),
+                      header.unit_symbol.begin());
+
+    writer.write(out, header);
+}
+
+// Sets a complexity analysis read from a saved report, already in the unit of the profile. Residuals were not saved,
+// they are recomputed from the loaded times while R² is kept as it was fitted
+template <ChronoDuration Unit>
+void attach_complexity(RuntimeProfile<Unit>& profile, ComplexityAnalysis&& analysis)
+{
+    std::vector<double> fit_sizes, fit_times;
+    fit_sizes.reserve(profile.size());
+    fit_times.reserve(profile.size());
+    for (size_t i = 0; i < profile.size(); ++i)
+    {
+        fit_sizes.push_back(static_cast<double>(profile.sample_sizes[i]));
+        fit_times.push_back(static_cast<double>(profile.raw_durations[i].count()));
+    }
+    for (auto& fit : analysis.fits)
+    {
+        const double r_squared = fit.r_squared;
+        score_fit(fit, fit_sizes, fit_times);
+        fit.r_squared = r_squared;
+    }
+    profile.complexity = std::move(analysis);
+}
+
+// Validated columns of a mapped binary profile
+class ProfileReader
+{
+public:
+    explicit ProfileReader(const std::filesystem::path& filename) : filename(filename), file(filename)
+    {
+        const auto bytes = file.bytes();
+        if (bytes.size() < sizeof(header)) { throw invalid("truncated header"); }
+        std::memcpy(&header, bytes.data(), sizeof(header));
+
+        if (header.magic != profile_magic) { throw invalid("bad magic"); }
+        if (header.version != profile_version) { throw invalid("unsupported version"); }
+        if (header.byte_order != archive_byte_order) { throw invalid("written with another byte order"); }
+        if (header.period_num <= 0 || header.period_den <= 0) { throw invalid("bad time unit"); }
+
+        const std::uint64_t metadata_offset =
+            sizeof(header) + std::uint64_t{header.column_count} * sizeof(ColumnDescriptor);
+        if (metadata_offset + header.metadata_size > bytes.size()) { throw invalid("truncated header"); }
+
+        descriptors.resize(header.column_count);
+        std::memcpy(descriptors.data(), bytes.data() + sizeof(header), descriptors.size() * sizeof(ColumnDescriptor));
+        for (const auto& descriptor : descriptors)
+        {
+            if (descriptor.offset % 8 != 0 || descriptor.offset > bytes.size() ||
+                descriptor.count > (bytes.size() - descriptor.offset) / 8)
+            {
+                throw invalid("truncated file");
+            }
+        }
+
+        metadata = {reinterpret_cast<const char*>(bytes.data() + metadata_offset), header.metadata_size};
+    }
+
+    [[nodiscard]] std::runtime_error invalid(const std::string& reason) const
+    {
+        return std::runtime_error("Error: " + filename.string() + " is not a valid binary profile (" + reason + ")");
+    }
+
+    [[nodiscard]] const ColumnDescriptor* find(std::string_view name) const noexcept
+    {
+        for (const auto& descriptor : descriptors)
+        {
+            if (std::string_view(descriptor.name.data()) == name) return &descriptor;
+        }
+        return nullptr;
+    }
+
+    // Values of a column, or nullopt when the file does not have it
+    template <typename T>
+    [[nodiscard]] std::optional<std::span<const T>> column(std::string_view name, std::uint64_t count) const
+    {
+        const auto* descriptor = find(name);
+        if (!descriptor) return std::nullopt;
+        if (descriptor->type != column_type<T>()) { throw invalid("type of column " + std::string(name)); }
+        if (descriptor->count != count) { throw invalid("length of column " + std::string(name)); }
+        return std::span(reinterpret_cast<const T*>(file.bytes().data() + descriptor->offset), descriptor->count);
+    }
+
+    template <typename T>
+    [[nodiscard]] std::span<const T> required_column(std::string_view name, std::uint64_t count) const
+    {
+        const auto values = column<T>(name, count);
+        if (!values) { throw invalid("missing column " + std::string(name)); }
+        return *values;
+    }
+
+    // Times of a column converted to Unit. Columns written by an integral unit with the same period are copied exactly
+    template <ChronoDuration Unit>
+    [[nodiscard]] std::vector<Unit> times(std::string_view name, std::uint64_t count) const
+    {
+        const auto* descriptor = find(name);
+        if (!descriptor) { throw invalid("missing column " + std::string(name)); }
+
+        const double factor = time_factor<Unit>();
+        const bool same_period = header.period_num == Unit::period::num && header.period_den == Unit::period::den;
+
+        std::vector<Unit> result;
+        result.reserve(count);
+        auto convert = [&](auto values) {
+            for (const auto value : values)
+            {
+                if constexpr (std::is_integral_v<typename Unit::rep> && std::is_integral_v<decltype(value)>)
+                {
+                    if (same_period)
+                    {
+                        result.emplace_back(static_cast<typename Unit::rep>(value));
+                        continue;
+                    }
+                }
+                result.emplace_back(static_cast<typename Unit::rep>(static_cast<double>(value) * factor));
+            }
+        };
+        if (descriptor->type == ColumnType::int64) { convert(required_column<std::int64_t>(name, count)); }
+        else { convert(required_column<double>(name, count)); }
+        return result;
+    }
+
+    // Stored period over the period of Unit
+    template <ChronoDuration Unit>
+    [[nodiscard]] double time_factor() const noexcept
+    {
+        return static_cast<double>(header.period_num) * static_cast<double>(Unit::period::den) /
+               (static_cast<double>(header.period_den) * static_cast<double>(Unit::period::num));
+    }
+
+    ProfileHeader header;
+    std::string_view metadata; // "key=value" lines
+
+private:
+    std::filesystem::path filename;
+    MappedFile file;
+    std::vector<ColumnDescriptor> descriptors;
+};
+
+// Fits stored as "class;intercept;coefficient;exponent;r_squared" metadata lines
+[[nodiscard]] inline std::optional<ComplexityAnalysis> parse_complexity(const ProfileReader& reader)
+{
+    std::optional<ComplexityAnalysis> analysis;
+    std::string_view best;
+
+    auto next_field = [](std::string_view& text, char separator) {
+        const auto end = text.find(separator);
+        const auto field = text.substr(0, end);
+        text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+        return field;
+    };
+
+    auto lines = reader.metadata;
+    while (!lines.empty())
+    {
+        auto value = next_field(lines, '\n');
+        const auto key = next_field(value, '=');
+        if (key == "complexity_best") { best = value; }
+        else if (key == "complexity_fit")
+        {
+            const auto complexity = parse_complexity_class(next_field(value, ';'));
+            if (!complexity) { throw reader.invalid("unknown complexity class"); }
+
+            std::array<double, 4> numbers{};
+            for (double& number : numbers)
+            {
+                const auto field = next_field(value, ';');
+                const auto [end, error] = std::from_chars(field.data(), field.data() + field.size(), number);
+                if (error != std::errc{}) { throw reader.invalid("malformed complexity fit"); }
+            }
+
+            if (!analysis) { analysis.emplace(); }
+            analysis->fits.push_back({.complexity = *complexity,
+                                      .intercept = numbers[0],
+                                      .coefficient = numbers[1],
+                                      .exponent = numbers[2],
+                                      .r_squared = numbers[3]});
+        }
+    }
+
+    if (analysis)
+    {
+        for (size_t i = 0; i < analysis->fits.size(); ++i)
+        {
+            if (to_string(analysis->fits[i].complexity) == best) { analysis->best = i; }
+        }
+    }
+    return analysis;
+}
+
+// Precision of the saved histograms, from the histogram_precision metadata line
+[[nodiscard]] inline unsigned parse_histogram_precision(const ProfileReader& reader)
+{
+    constexpr std::string_view key = "histogram_precision=";
+    const std::string_view metadata = reader.metadata;
+    const auto start = metadata.find(key);
+    if (start == std::string_view::npos) { throw reader.invalid("histogram precision missing"); }
+
+    const auto value = metadata.substr(start + key.size());
+    unsigned precision = 0;
+    const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), precision);
+    if (error != std::errc{} || precision == 0 || precision > LatencyHistogram::max_precision_bits)
+    {
+        throw reader.invalid("bad histogram precision");
+    }
+    return precision;
+}
+
+// Peak bandwidth the profile was compared with, from the peak_bandwidth metadata line
+[[nodiscard]] inline std::optional<double> parse_peak_bandwidth(const ProfileReader& reader)
+{
+    constexpr std::string_view key = "peak_bandwidth=";
+    const std::string_view metadata = reader.metadata;
+    const auto start = metadata.find(key);
+    if (start == std::string_view::npos) return std::nullopt;
+
+    const auto value = metadata.substr(start + key.size());
+    double peak = 0.0;
+    const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), peak);
+    if (error != std::errc{} || !(peak > 0.0)) { throw reader.invalid("bad peak bandwidth"); }
+    return peak;
+}
+
+// Offsets of a ragged column, one per sample and the end. They must start at 0 and never decrease, so every slice
+// lies within the data column of offsets.back() entries
+[[nodiscard]] inline bool valid_offsets(std::span<const std::uint64_t> offsets) noexcept
+{
+    return !offsets.empty() && offsets.front() == 0 && std::ranges::is_sorted(offsets);
+}
+
+} // namespace detail
+
+// Reads a profile saved with the .srp extension. Times are converted to Unit like the RuntimeProfile conversion
+// constructor does, so a profile saved in nanoseconds can be loaded in Fractional<microseconds>
+template <ChronoDuration Unit>
+[[nodiscard]] RuntimeProfile<Unit> load_binary_profile(const std::filesystem::path& filename)
+{
+    const detail::ProfileReader reader(filename);
+    const std::uint64_t samples = reader.header.sample_count;
+
+    RuntimeProfile<Unit> profile;
+    const auto sizes = reader.required_column<std::uint64_t>("sample_size", samples);
+    profile.sample_sizes.assign(sizes.begin(), sizes.end());
+    profile.raw_durations = reader.times<Unit>("time_value", samples);
+
+    const auto offsets = reader.required_column<std::uint64_t>("repetition_offsets", samples + 1);
+    if (!detail::valid_offsets(offsets)) { throw reader.invalid("inconsistent repetition offsets"); }
+    const auto repetitions = reader.times<Unit>("repetitions", offsets.back());
+    profile.repetitions.reserve(samples);
+    for (std::uint64_t i = 0; i < samples; ++i)
+    {
+        profile.repetitions.emplace_back(repetitions.begin() + static_cast<std::ptrdiff_t>(offsets[i]),
+                                         repetitions.begin() + static_cast<std::ptrdiff_t>(offsets[i + 1]));
+    }
+
+    if (reader.find("histogram_offsets"))
+    {
+        const auto precision = detail::parse_histogram_precision(reader);
+        const auto offsets = reader.required_column<std::uint64_t>("histogram_offsets", samples + 1);
+        if (!detail::valid_offsets(offsets)) { throw reader.invalid("inconsistent histogram offsets"); }
+        const auto buckets = reader.required_column<std::uint64_t>("histogram_buckets", offsets.back());
+        const auto counts = reader.required_column<std::uint64_t>("histogram_counts", offsets.back());
+        const auto minimums = reader.required_column<std::uint64_t>("histogram_min", samples);
+        const auto maximums = reader.required_column<std::uint64_t>("histogram_max", samples);
+        const auto sums = reader.required_column<std::uint64_t>("histogram_sum", samples);
+
+        profile.histograms.reserve(samples);
+        for (std::uint64_t i = 0; i < samples; ++i)
+        {
+            auto& histogram = profile.histograms.emplace_back(precision);
+            for (auto b = offsets[i]; b < offsets[i + 1]; ++b)
+            {
+                if (buckets[b] >= histogram.bucket_count()) { throw reader.invalid("histogram bucket out of range"); }
+                histogram.record(histogram.bucket_lower_bound(buckets[b]), counts[b]);
+            }
+            histogram.restore_totals(minimums[i], maximums[i], sums[i]);
+        }
+    }
+
+    // Counter columns are written together, a NaN marks a counter that was not available for the sample
+    if (reader.find(detail::counter_fields.front().name))
+    {
+        profile.counters.resize(samples);
+        for (const auto& field : detail::counter_fields)
+        {
+            const auto values = reader.required_column<double>(field.name, samples);
+            for (std::uint64_t i = 0; i < samples; ++i)
+            {
+                if (!std::isnan(values[i])) { profile.counters[i].*field.member = values[i]; }
+            }
+        }
+    }
+
+    if (reader.find("allocations"))
+    {
+        const auto allocations = reader.required_column<double>("allocations", samples);
+        const auto bytes_allocated = reader.required_column<double>("bytes_allocated", samples);
+        const auto peak_live_bytes = reader.required_column<std::uint64_t>("peak_live_bytes", samples);
+        profile.allocations.reserve(samples);
+        for (std::uint64_t i = 0; i < samples; ++i)
+        {
+            profile.allocations.push_back({.allocations = allocations[i],
+                                           .bytes_allocated = bytes_allocated[i],
+                                           .peak_live_bytes = static_cast<size_t>(peak_live_bytes[i])});
+        }
+    }
+
+    if (const auto cpu_ids = reader.column<std::int64_t>("cpu_id", samples))
+    {
+        profile.cpu_ids.reserve(samples);
+        for (const auto cpu : *cpu_ids) { profile.cpu_ids.push_back(static_cast<int>(cpu)); }
+    }
+
+    if (reader.find("max_rss_bytes"))
+    {
+        const auto max_rss_bytes = reader.required_column<std::uint64_t>("max_rss_bytes", samples);
+        const auto voluntary_switches = reader.required_column<std::uint64_t>("voluntary_switches", samples);
+        const auto involuntary_switches = reader.required_column<std::uint64_t>("involuntary_switches", samples);
+        profile.process_usage.reserve(samples);
+        for (std::uint64_t i = 0; i < samples; ++i)
+        {
+            profile.process_usage.push_back({.max_rss_bytes = static_cast<size_t>(max_rss_bytes[i]),
+                                             .voluntary_switches = voluntary_switches[i],
+                                             .involuntary_switches = involuntary_switches[i]});
+        }
+    }
+
+    if (const auto cache_modes = reader.column<std::int64_t>("cache_mode", samples))
+    {
+        profile.cache_modes.reserve(samples);
+        for (const auto mode : *cache_modes)
+        {
+            if (mode < 0 || mode > static_cast<std::int64_t>(CacheMode::tlb_cold))
+            {
+                throw reader.invalid("unknown cache mode");
+            }
+            profile.cache_modes.push_back(static_cast<CacheMode>(mode));
+        }
+    }
+
+    if (reader.find("items"))
+    {
+        const auto items = reader.required_column<std::uint64_t>("items", samples);
+        const auto bytes = reader.required_column<std::uint64_t>("bytes", samples);
+        profile.throughput.reserve(samples);
+        for (std::uint64_t i = 0; i < samples; ++i)
+        {
+            profile.throughput.push_back({.items = items[i], .bytes = bytes[i]});
+        }
+    }
+    profile.peak_bandwidth = detail::parse_peak_bandwidth(reader);
+
+    if (auto complexity = detail::parse_complexity(reader))
+    {
+        complexity->rescale(reader.time_factor<Unit>());
+        detail::attach_complexity(profile, std::move(*complexity));
+    }
+
+    return profile;
+}
+
+} // namespace sra
@@ -0,0 +1,268 @@
+/**
+ * @file cache_control.hpp
+ * * @brief Warm, cold and TLB-cold cache states before each timed region
+ *
+ * @project Simple Runtime Analyzer
+ *
+ * @author Diego Osorio (ShineKnightDev)
+ *
+ * @copyright Copyright (c) 2025 Diego Osorio (ShineKnightDev)
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#    define SRA_HAS_CLFLUSH 1
+#    if defined(_MSC_VER)
+#        include <intrin.h>
+#    else
+#        include <x86intrin.h>
+#    endif
+#else
+#    define SRA_HAS_CLFLUSH 0
+#endif
+
+#if defined(__linux__)
+#    include <sys/mman.h>
+#    include <unistd.h>
+#endif
+
+namespace sra
+{
+
+// Cache state each timed region starts in
+enum class CacheMode
+{
+    unchanged, // Whatever the previous region left behind
+    warm,      // Every cache line of the input read right before the region
+    cold,      // Data caches evicted by sweeping a buffer larger than the last-level cache
+    tlb_cold   // Input warm in the data caches, but its page translations evicted from the TLB
+};
+
+[[nodiscard]] constexpr std::string_view to_string(CacheMode mode) noexcept
+{
+    switch (mode)
+    {
+        case CacheMode::unchanged: return "unchanged";
+        case CacheMode::warm: return "warm";
+        case CacheMode::cold: return "cold";
+        case CacheMode::tlb_cold: return "tlb_cold";
+    }
+    return "unknown";
+}
+
+namespace detail
+{
+
+inline constexpr size_t cache_line_bytes = 64;
+inline constexpr size_t default_last_level_cache_bytes = size_t{32} << 20;
+
+[[nodiscard]] inline std::optional<CacheMode> parse_cache_mode(std::string_view name) noexcept
+{
+    for (const auto mode : {CacheMode::unchanged, CacheMode::warm, CacheMode::cold, CacheMode::tlb_cold})
+    {
+        if (to_string(mode) == name) return mode;
+    }
+    return std::nullopt;
+}
+
+// Size in bytes of a sysfs cache size such as "32768K" or "8M"
+[[nodiscard]] inline std::optional<size_t> parse_cache_size(std::string_view text) noexcept
+{
+    size_t value = 0;
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (error != std::errc{} || value == 0) return std::nullopt;
+
+    const std::string_view suffix(end, text.data() + text.size() - end);
+    if (suffix.starts_with('K')) return value << 10;
+    if (suffix.starts_with('M')) return value << 20;
+    if (suffix.starts_with('G')) return value << 30;
+    return value;
+}
+
+// Memory read by a call on `input`: the elements of a contiguous range, otherwise the object itself. Node-based
+// containers only expose their header
+template <typename T>
+[[nodiscard]] std::span<const std::byte> input_bytes(const T& input) noexcept
+{
+    if constexpr (std::ranges::contiguous_range<const T> && std::ranges::sized_range<const T>)
+    {
+        return std::as_bytes(std::span(std::ranges::data(input), std::ranges::size(input)));
+    }
+    else { return std::as_bytes(std::span(&input, 1)); }
+}
+
+[[nodiscard]] inline size_t page_bytes() noexcept
+{
+#if defined(__linux__)
+    static const auto bytes = static_cast<size_t>(std::max(sysconf(_SC_PAGESIZE), 4096L));
+    return bytes;
+#else
+    return 4096;
+#endif
+}
+
+struct PageAlignedDelete
+{
+    void operator()(std::byte* buffer) const noexcept { ::operator delete(buffer, std::align_val_t{page_bytes()}); }
+};
+
+[[nodiscard]] inline std::string read_first_line(const std::string& path)
+{
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);
+    return line;
+}
+
+} // namespace detail
+
+// Size of the highest-level data or unified cache of cpu0 from sysfs, 32 MiB when it cannot be read
+[[nodiscard]] inline size_t last_level_cache_bytes()
+{
+    static const size_t bytes = [] {
+        size_t best_level = 0, best_size = 0;
+#if defined(__linux__)
+        for (int index = 0; index < 16; ++index)
+        {
+            const std::string dir = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index) + "/";
+            const auto level_text = detail::read_first_line(dir + "level");
+            if (level_text.empty()) { break; }
+            if (detail::read_first_line(dir + "type") == "Instruction") { continue; }
+
+            const auto level = detail::parse_cache_size(level_text);
+            const auto size = detail::parse_cache_size(detail::read_first_line(dir + "size"));
+            if (level && size && *level >= best_level)
+            {
+                best_level = *level;
+                best_size = *size;
+            }
+        }
+#endif
+        return best_size != 0 ? best_size : detail::default_last_level_cache_bytes;
+    }();
+    return bytes;
+}
+
+// Reads one byte of every cache line of `bytes`
+inline void touch_cache_lines(std::span<const std::byte> bytes) noexcept
+{
+    std::uint8_t sum = 0;
+    for (size_t offset = 0; offset < bytes.size(); offset += detail::cache_line_bytes)
+    {
+        sum = static_cast<std::uint8_t>(sum + static_cast<std::uint8_t>(bytes[offset]));
+    }
+    if (!bytes.empty()) { sum = static_cast<std::uint8_t>(sum + static_cast<std::uint8_t>(bytes.back())); }
+    const volatile std::uint8_t sink = sum;
+    static_cast<void>(sink);
+}
+
+// Writes back and invalidates every cache line of `bytes` with clflush. Does nothing without clflush
+inline void flush_cache_lines(std::span<const std::byte> bytes) noexcept
+{
+#if SRA_HAS_CLFLUSH
+    if (bytes.empty()) return;
+    const auto first = reinterpret_cast<std::uintptr_t>(bytes.data()) & ~(detail::cache_line_bytes - 1);
+    const auto last = reinterpret_cast<std::uintptr_t>(bytes.data() + bytes.size());
+    for (auto line = first; line < last; line += detail::cache_line_bytes)
+    {
+        _mm_clflush(reinterpret_cast<const void*>(line));
+    }
+    _mm_mfence();
+#else
+    static_cast<void>(bytes);
+#endif
+}
+
+// Puts the caches in the requested state before a timed region. The eviction buffer is allocated on first use and
+// kept, so conditioning allocates nothing while measuring
+class CacheConditioner
+{
+public:
+    explicit CacheConditioner(CacheMode mode, bool flush_input = false, size_t eviction_bytes = 0)
+        : mode(mode)
+        , flush_input(flush_input)
+        , eviction_bytes(eviction_bytes != 0 ? eviction_bytes : 2 * last_level_cache_bytes())
+    {
+    }
+
+    [[nodiscard]] CacheMode cache_mode() const noexcept { return mode; }
+
+    // Conditions the caches for a region reading `inputs`, a callable invoked with a visitor of input byte spans
+    template <typename ForEachInput>
+    void prepare(ForEachInput&& for_each_input)
+    {
+        switch (mode)
+        {
+            case CacheMode::unchanged: break;
+            case CacheMode::warm: for_each_input(touch_cache_lines); break;
+            case CacheMode::cold:
+                evict_caches();
+                if (flush_input) { for_each_input(flush_cache_lines); }
+                break;
+            case CacheMode::tlb_cold:
+                // The page sweep touches one line per page, so the input is still mostly cached when it is warmed
+                for_each_input(touch_cache_lines);
+                evict_tlb();
+                break;
+        }
+    }
+
+private:
+    [[nodiscard]] std::byte* eviction_buffer()
+    {
+        if (!buffer)
+        {
+            const std::align_val_t alignment{detail::page_bytes()};
+            auto* memory = static_cast<std::byte*>(::operator new(eviction_bytes, alignment));
+            buffer.reset(memory);
+#if defined(__linux__) && defined(MADV_NOHUGEPAGE)
+            // Huge pages would cover the buffer with a handful of TLB entries
+            madvise(memory, eviction_bytes, MADV_NOHUGEPAGE);
+#endif
+            std::fill_n(memory, eviction_bytes, std::byte{0});
+        }
+        return buffer.get();
+    }
+
+    // Read-modify-write of every line, so dirty lines of the input are written back and replaced
+    void evict_caches()
+    {
+        volatile std::byte* lines = eviction_buffer();
+        for (size_t offset = 0; offset < eviction_bytes; offset += detail::cache_line_bytes)
+        {
+            lines[offset] = static_cast<std::byte>(static_cast<unsigned>(lines[offset]) + 1);
+        }
+    }
+
+    // One read per page loads a new translation for each page of the buffer
+    void evict_tlb()
+    {
+        const volatile std::byte* pages = eviction_buffer();
+        std::byte last{};
+        for (size_t offset = 0; offset < eviction_bytes; offset += detail::page_bytes()) { last = pages[offset]; }
+        static_cast<void>(last);
+    }
+
+    CacheMode mode;
+    bool flush_input;
+    size_t eviction_bytes;
+    std::unique_ptr<std::byte, detail::PageAlignedDelete> buffer;
+};
+
+} // namespace sra
@@ -0,0 +1,240 @@
+/**
+ * @file complexity_analyzer.hpp
+ * * @brief Empirical complexity estimation by least-squares fitting
+ *
+ * @project Simple Runtime Analyzer
+ *
+ * @author Diego Osorio (ShineKnightDev)
+ *
+ * @copyright Copyright (c) 2025 Diego Osorio (ShineKnightDev)
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+namespace sra
+{
+
+enum class ComplexityClass
+{
+    constant,
+    logarithmic,
+    linear,
+    linearithmic,
+    quadratic,
+    cubic,
+    power_law
+};
+
+[[nodiscard]] constexpr std::string_view to_string(ComplexityClass complexity) noexcept
+{
+    switch (complexity)
+    {
+        case ComplexityClass::constant: return "O(1)";
+        case ComplexityClass::logarithmic: return "O(log n)";
+        case ComplexityClass::linear: return "O(n)";
+        case ComplexityClass::linearithmic: return "O(n log n)";
+        case ComplexityClass::quadratic: return "O(n^2)";
+        case ComplexityClass::cubic: return "O(n^3)";
+        case ComplexityClass::power_law: return "O(n^k)";
+    }
+    return "unknown";
+}
+
+// time(n) = intercept + coefficient * f(n), or coefficient * n^exponent for the power law. Logarithms are natural
+struct ComplexityFit
+{
+    ComplexityClass complexity = ComplexityClass::constant;
+    double intercept = 0.0;
+    double coefficient = 0.0;
+    double exponent = 0.0; // Only meaningful for the power law
+    double r_squared = 0.0;
+    std::vector<double> residuals{}; // Measured minus predicted time of each sample
+
+    [[nodiscard]] double predict(double n) const noexcept
+    {
+        switch (complexity)
+        {
+            case ComplexityClass::constant: return intercept;
+            case ComplexityClass::logarithmic: return intercept + coefficient * std::log(n);
+            case ComplexityClass::linear: return intercept + coefficient * n;
+            case ComplexityClass::linearithmic: return intercept + coefficient * n * std::log(n);
+            case ComplexityClass::quadratic: return intercept + coefficient * n * n;
+            case ComplexityClass::cubic: return intercept + coefficient * n * n * n;
+            case ComplexityClass::power_law: return coefficient * std::pow(n, exponent);
+        }
+        return 0.0;
+    }
+};
+
+struct ComplexityAnalysis
+{
+    std::vector<ComplexityFit> fits; // Every candidate that could be fitted, in ComplexityClass order
+    size_t best = 0;                 // Index of the best-fitting class, never the power law
+
+    [[nodiscard]] const ComplexityFit& best_fit() const { return fits.at(best); }
+
+    // Converts times, e.g. when the profile changes unit. R² does not depend on the unit
+    void rescale(double factor) noexcept
+    {
+        for (auto& fit : fits)
+        {
+            fit.intercept *= factor;
+            fit.coefficient *= factor;
+            for (double& residual : fit.residuals) { residual *= factor; }
+        }
+    }
+};
+
+namespace detail
+{
+
+inline constexpr std::array<ComplexityClass, 6> fixed_complexity_classes = {
+    ComplexityClass::constant,     ComplexityClass::logarithmic, ComplexityClass::linear,
+    ComplexityClass::linearithmic, ComplexityClass::quadratic,   ComplexityClass::cubic,
+};
+
+struct LineFit
+{
+    double intercept = 0.0;
+    double slope = 0.0;
+};
+
+// Ordinary least squares of y = intercept + slope * x
+inline LineFit fit_line(std::span<const double> x, std::span<const double> y) noexcept
+{
+    const double n = static_cast<double>(x.size());
+    double mean_x = 0.0, mean_y = 0.0;
+    for (size_t i = 0; i < x.size(); ++i)
+    {
+        mean_x += x[i];
+        mean_y += y[i];
+    }
+    mean_x /= n;
+    mean_y /= n;
+
+    double covariance = 0.0, variance = 0.0;
+    for (size_t i = 0; i < x.size(); ++i)
+    {
+        covariance += (x[i] - mean_x) * (y[i] - mean_y);
+        variance += (x[i] - mean_x) * (x[i] - mean_x);
+    }
+
+    const double slope = variance > 0.0 ? covariance / variance : 0.0;
+    return {mean_y - slope * mean_x, slope};
+}
+
+// Fills residuals and R² of a fit whose parameters are already set
+inline void score_fit(ComplexityFit& fit, std::span<const double> sizes, std::span<const double> times)
+{
+    double mean = 0.0;
+    for (double t : times) { mean += t; }
+    mean /= static_cast<double>(times.size());
+
+    double residual_sum = 0.0, total_sum = 0.0;
+    fit.residuals.clear();
+    fit.residuals.reserve(times.size());
+    for (size_t i = 0; i < times.size(); ++i)
+    {
+        const double residual = times[i] - fit.predict(sizes[i]);
+        fit.residuals.push_back(residual);
+        residual_sum += residual * residual;
+        total_sum += (times[i] - mean) * (times[i] - mean);
+    }
+
+    if (total_sum > 0.0) { fit.r_squared = 1.0 - residual_sum / total_sum; }
+    else { fit.r_squared = residual_sum == 0.0 ? 1.0 : 0.0; }
+}
+
+inline ComplexityFit fit_class(ComplexityClass complexity, std::span<const double> sizes, std::span<const double> times)
+{
+    ComplexityFit fit;
+    fit.complexity = complexity;
+
+    if (complexity == ComplexityClass::constant)
+    {
+        for (double t : times) { fit.intercept += t; }
+        fit.intercept /= static_cast<double>(times.size());
+    }
+    else
+    {
+        // predict() with a unit coefficient and no intercept gives the basis function f(n)
+        const ComplexityFit basis{.complexity = complexity, .coefficient = 1.0};
+        std::vector<double> x;
+        x.reserve(sizes.size());
+        for (double n : sizes) { x.push_back(basis.predict(n)); }
+
+        const auto line = fit_line(x, times);
+        fit.intercept = line.intercept;
+        fit.coefficient = line.slope;
+    }
+
+    score_fit(fit, sizes, times);
+    return fit;
+}
+
+// log(time) = log(coefficient) + exponent * log(n), only defined for positive times
+inline std::optional<ComplexityFit> fit_power_law(std::span<const double> sizes, std::span<const double> times)
+{
+    std::vector<double> log_sizes, log_times;
+    log_sizes.reserve(sizes.size());
+    log_times.reserve(times.size());
+    for (size_t i = 0; i < sizes.size(); ++i)
+    {
+        if (times[i] <= 0.0) return std::nullopt;
+        log_sizes.push_back(std::log(sizes[i]));
+        log_times.push_back(std::log(times[i]));
+    }
+
+    const auto line = fit_line(log_sizes, log_times);
+    ComplexityFit fit;
+    fit.complexity = ComplexityClass::power_law;
+    fit.coefficient = std::exp(line.intercept);
+    fit.exponent = line.slope;
+    score_fit(fit, sizes, times);
+    return fit;
+}
+
+} // namespace detail
+
+// Fits every complexity class to (size, time) pairs. The best class has the highest R² among the fits whose
+// coefficient is not negative, since a decreasing curve cannot describe a cost that grows with n
+[[nodiscard]] inline ComplexityAnalysis fit_complexity(std::span<const double> sizes, std::span<const double> times)
+{
+    if (sizes.size() != times.size()) { throw std::invalid_argument("Complexity fitting requires one time per size"); }
+
+    if (std::ranges::any_of(sizes, [](double n) { return n < 1.0; }))
+    {
+        throw std::invalid_argument("Complexity fitting requires sample sizes of at least 1");
+    }
+    if (sizes.empty() || std::ranges::all_of(sizes, [&sizes](double n) { return n == sizes.front(); }))
+    {
+        throw std::invalid_argument("Complexity fitting requires at least two distinct sample sizes");
+    }
+
+    ComplexityAnalysis analysis;
+    for (const auto complexity : detail::fixed_complexity_classes)
+    {
+        analysis.fits.push_back(detail::fit_class(complexity, sizes, times));
+
+        const auto& fit = analysis.fits.back();
+        const auto& best = analysis.fits[analysis.best];
+        if (fit.coefficient >= 0.0 && fit.r_squared > best.r_squared) { analysis.best = analysis.fits.size() - 1; }
+    }
+
+    if (auto power_law = detail::fit_power_law(sizes, times)) { analysis.fits.push_back(std::move(*power_law)); }
+
+    return analysis;
+}
+
+} // namespace sra
@@ -0,0 +1,188 @@
+/**
+ * @file hardware_counters.hpp
+ * * @brief Hardware performance counters via Linux perf_event_open
+ *
+ * @project Simple Runtime Analyzer
+ *
+ * @author Diego Osorio (ShineKnightDev)
+ *
+ * @copyright Copyright (c) 2025 Diego Osorio (ShineKnightDev)
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#if defined(__linux__)
+#    include <linux/perf_event.h>
+#    include <sys/ioctl.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+
+#    include <cerrno>
+#    include <cstring>
+#endif
+
+namespace sra
+{
+
+// Per-call averages over the timed regions of one sample. Counters the kernel refused to open are empty
+struct HardwareCounters
+{
+    std::optional<double> cycles;
+    std::optional<double> instructions;
+    std::optional<double> cache_misses;
+    std::optional<double> branch_misses;
+    std::optional<double> page_faults;
+};
+
+namespace detail
+{
+
+struct CounterField
+{
+    std::string_view name;
+    std::optional<double> HardwareCounters::* member;
+};
+
+inline constexpr std::array<CounterField, 5> counter_fields = {{
+    {"cycles", &HardwareCounters::cycles},
+    {"instructions", &HardwareCounters::instructions},
+    {"cache_misses", &HardwareCounters::cache_misses},
+    {"branch_misses", &HardwareCounters::branch_misses},
+    {"page_faults", &HardwareCounters::page_faults},
+}};
+
+} // namespace detail
+
+// Group of counters opened for the calling thread. Counting only happens between start() and stop()
+class PerfCounterGroup
+{
+public:
+    PerfCounterGroup()
+    {
+#if defined(__linux__)
+        struct EventConfig
+        {
+            std::uint32_t type;
+            std::uint64_t config;
+        };
+
+        static constexpr std::array<EventConfig, detail::counter_fields.size()> events = {{
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+            {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+        }};
+
+        std::string denied;
+        for (size_t i = 0; i < events.size(); ++i)
+        {
+            perf_event_attr attr{};
+            attr.type = events[i].type;
+            attr.size = sizeof(perf_event_attr);
+            attr.config = events[i].config;
+            attr.disabled = leader_fd < 0 ? 1 : 0;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            const int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, leader_fd, 0));
+            if (fd < 0)
+            {
+                denied += std::string(denied.empty() ? "" : ", ") + std::string(detail::counter_fields[i].name) + " (" +
+                          std::strerror(errno) + ")";
+                continue;
+            }
+
+            if (leader_fd < 0) { leader_fd = fd; }
+            fds[i] = fd;
+            slots[i] = opened++;
+        }
+
+        if (opened == 0) { status_message = "perf_event_open unavailable: " + denied; }
+        else if (!denied.empty()) { status_message = "partial: could not open " + denied; }
+        else { status_message = "enabled"; }
+#else
+        status_message = "hardware counters require Linux perf_event_open";
+#endif
+    }
+
+    ~PerfCounterGroup()
+    {
+#if defined(__linux__)
+        for (int fd : fds)
+        {
+            if (fd >= 0) { close(fd); }
+        }
+#endif
+    }
+
+    PerfCounterGroup(const PerfCounterGroup&) = delete;
+    PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+
+    [[nodiscard]] bool available() const noexcept { return leader_fd >= 0; }
+
+    // "enabled", "partial: ..." or the reason counters are unavailable
+    [[nodiscard]] const std::string& status() const noexcept { return status_message; }
+
+    void start() noexcept
+    {
+#if defined(__linux__)
+        if (leader_fd < 0) return;
+        ioctl(leader_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(leader_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    // Stops counting and adds the values (scaled for multiplexing) to the running totals
+    void stop() noexcept
+    {
+#if defined(__linux__)
+        if (leader_fd < 0) return;
+        ioctl(leader_fd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+        // Layout of a PERF_FORMAT_GROUP read: nr, time_enabled, time_running, values[nr]
+        std::array<std::uint64_t, 3 + detail::counter_fields.size()> buffer{};
+        if (read(leader_fd, buffer.data(), sizeof(buffer)) <= 0) return;
+
+        const double enabled = static_cast<double>(buffer[1]);
+        const double running = static_cast<double>(buffer[2]);
+        const double scale = running > 0.0 ? enabled / running : 1.0;
+        for (size_t i = 0; i < totals.size(); ++i)
+        {
+            if (fds[i] >= 0) { totals[i] += static_cast<double>(buffer[3 + slots[i]]) * scale; }
+        }
+#endif
+    }
+
+    // Per-call averages of the totals accumulated since the last call, then clears them
+    [[nodiscard]] HardwareCounters take(size_t calls) noexcept
+    {
+        HardwareCounters result;
+        const double divisor = calls > 0 ? static_cast<double>(calls) : 1.0;
+        for (size_t i = 0; i < totals.size(); ++i)
+        {
+            if (fds[i] >= 0) { result.*detail::counter_fields[i].member = totals[i] / divisor; }
+            totals[i] = 0.0;
+        }
+        return result;
+    }
+
+private:
+    std::array<int, detail::counter_fields.size()> fds = {-1, -1, -1, -1, -1};
+    std::array<size_t, detail::counter_fields.size()> slots{};
+    std::array<double, detail::counter_fields.size()> totals{};
+    int leader_fd = -1;
+    size_t opened = 0;
+    std::string status_message;
+};
+
+} // namespace sra
@@ -0,0 +1,273 @@
+/**
+ * @file latency_histogram.hpp
+ * * @brief Fixed-memory log-linear histogram of durations with lock-free recording
+ *
+ * @project Simple Runtime Analyzer
+ *
+ * @author Diego Osorio (ShineKnightDev)
+ *
+ * @copyright Copyright (c) 2025 Diego Osorio (ShineKnightDev)
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace sra
+{
+
+// HDR-style histogram of non-negative integer values, e.g. nanoseconds. Values below 2^precision_bits have a bucket
+// each, and every higher power of two is split into 2^precision_bits buckets, so the memory is fixed and any
+// percentile is within 2^-(precision_bits + 1) of a recorded value. Recording is a few relaxed atomic operations, so
+// threads may share one histogram or fill their own and merge them
+class LatencyHistogram
+{
+public:
+    static constexpr unsigned default_precision_bits = 7;
+    static constexpr unsigned max_precision_bits = 16;
+
+    explicit LatencyHistogram(unsigned precision_bits = default_precision_bits)
+        : sub_bits(precision_bits)
+        , counts(bucket_count_for(precision_bits))
+    {
+    }
+
+    // Copies are snapshots, they should not be taken while other threads record
+    LatencyHistogram(const LatencyHistogram& other)
+        : sub_bits(other.sub_bits)
+        , counts(other.counts.size())
+    {
+        copy_counters(other);
+    }
+
+    LatencyHistogram(LatencyHistogram&& other) noexcept
+        : sub_bits(other.sub_bits)
+        , counts(std::move(other.counts))
+    {
+        copy_counters(other, false);
+    }
+
+    LatencyHistogram& operator=(const LatencyHistogram& other)
+    {
+        if (this != &other)
+        {
+            sub_bits = other.sub_bits;
+            counts = std::vector<std::atomic<std::uint64_t>>(other.counts.size());
+            copy_counters(other);
+        }
+        return *this;
+    }
+
+    LatencyHistogram& operator=(LatencyHistogram&& other) noexcept
+    {
+        if (this != &other)
+        {
+            sub_bits = other.sub_bits;
+            counts = std::move(other.counts);
+            copy_counters(other, false);
+        }
+        return *this;
+    }
+
+    // Adds `occurrences` values equal to `value`
+    void record(std::uint64_t value, std::uint64_t occurrences = 1) noexcept
+    {
+        if (occurrences == 0) return;
+        counts[bucket_index(value)].fetch_add(occurrences, std::memory_order_relaxed);
+        total.fetch_add(occurrences, std::memory_order_relaxed);
+        value_sum.fetch_add(value * occurrences, std::memory_order_relaxed);
+
+        auto current = min_value.load(std::memory_order_relaxed);
+        while (value < current && !min_value.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+        current = max_value.load(std::memory_order_relaxed);
+        while (value > current && !max_value.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+    }
+
+    void merge(const LatencyHistogram& other)
+    {
+        if (other.sub_bits != sub_bits)
+        {
+            throw std::invalid_argument("Cannot merge latency histograms with different precisions");
+        }
+
+        for (size_t i = 0; i < counts.size(); ++i)
+        {
+            const auto n = other.counts[i].load(std::memory_order_relaxed);
+            if (n != 0) { counts[i].fetch_add(n, std::memory_order_relaxed); }
+        }
+        total.fetch_add(other.count(), std::memory_order_relaxed);
+        value_sum.fetch_add(other.sum(), std::memory_order_relaxed);
+        if (other.count() != 0)
+        {
+            min_value.store(std::min(min(), other.min()), std::memory_order_relaxed);
+            max_value.store(std::max(max(), other.max()), std::memory_order_relaxed);
+        }
+    }
+
+    // Sets the exact minimum, maximum and sum of a histogram rebuilt bucket by bucket, e.g. from a saved profile
+    void restore_totals(std::uint64_t minimum, std::uint64_t maximum, std::uint64_t total_sum) noexcept
+    {
+        min_value.store(minimum, std::memory_order_relaxed);
+        max_value.store(maximum, std::memory_order_relaxed);
+        value_sum.store(total_sum, std::memory_order_relaxed);
+    }
+
+    void reset() noexcept
+    {
+        for (auto& n : counts) { n.store(0, std::memory_order_relaxed); }
+        total.store(0, std::memory_order_relaxed);
+        value_sum.store(0, std::memory_order_relaxed);
+        min_value.store(std::numeric_limits<std::uint64_t>::max(), std::memory_order_relaxed);
+        max_value.store(0, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] std::uint64_t count() const noexcept { return total.load(std::memory_order_relaxed); }
+    [[nodiscard]] std::uint64_t sum() const noexcept { return value_sum.load(std::memory_order_relaxed); }
+    [[nodiscard]] bool empty() const noexcept { return count() == 0; }
+
+    // Exact smallest and largest recorded values, 0 when empty
+    [[nodiscard]] std::uint64_t min() const noexcept { return empty() ? 0 : min_value.load(std::memory_order_relaxed); }
+    [[nodiscard]] std::uint64_t max() const noexcept { return max_value.load(std::memory_order_relaxed); }
+
+    // Exact mean of the recorded values
+    [[nodiscard]] double mean() const noexcept
+    {
+        return empty() ? 0.0 : static_cast<double>(sum()) / static_cast<double>(count());
+    }
+
+    // Sample standard deviation, with every value taken at the midpoint of its bucket
+    [[nodiscard]] double stddev() const noexcept
+    {
+        const auto n = count();
+        if (n < 2) return 0.0;
+
+        const double average = mean();
+        double squared = 0.0;
+        for (size_t i = 0; i < counts.size(); ++i)
+        {
+            const auto c = counts[i].load(std::memory_order_relaxed);
+            if (c == 0) continue;
+            const double delta = midpoint(i) - average;
+            squared += static_cast<double>(c) * delta * delta;
+        }
+        return std::sqrt(squared / static_cast<double>(n - 1));
+    }
+
+    // Midpoint of the bucket holding the q-quantile, clamped to the recorded range, 0 when empty
+    [[nodiscard]] double percentile(double q) const noexcept
+    {
+        const auto n = count();
+        if (n == 0) return 0.0;
+
+        const auto rank = static_cast<std::uint64_t>(std::clamp(q, 0.0, 1.0) * static_cast<double>(n - 1));
+        std::uint64_t seen = 0;
+        for (size_t i = 0; i < counts.size(); ++i)
+        {
+            seen += counts[i].load(std::memory_order_relaxed);
+            if (seen > rank) return midpoint(i);
+        }
+        return static_cast<double>(max());
+    }
+
+    // Median of the distances of bucket midpoints to the median
+    [[nodiscard]] double median_absolute_deviation() const
+    {
+        const auto n = count();
+        if (n == 0) return 0.0;
+
+        const double median = percentile(0.5);
+        std::vector<std::pair<double, std::uint64_t>> deviations;
+        for (size_t i = 0; i < counts.size(); ++i)
+        {
+            const auto c = counts[i].load(std::memory_order_relaxed);
+            if (c != 0) { deviations.emplace_back(std::abs(midpoint(i) - median), c); }
+        }
+        std::ranges::sort(deviations);
+
+        const auto rank = (n - 1) / 2;
+        std::uint64_t seen = 0;
+        for (const auto& [deviation, c] : deviations)
+        {
+            seen += c;
+            if (seen > rank) return deviation;
+        }
+        return deviations.empty() ? 0.0 : deviations.back().first;
+    }
+
+    // Raw buckets, e.g. to save the histogram. record(bucket_lower_bound(i), count_at(i)) rebuilds bucket i
+    [[nodiscard]] unsigned precision_bits() const noexcept { return sub_bits; }
+    [[nodiscard]] size_t bucket_count() const noexcept { return counts.size(); }
+    [[nodiscard]] std::uint64_t count_at(size_t index) const noexcept
+    {
+        return counts[index].load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] std::uint64_t bucket_lower_bound(size_t index) const noexcept
+    {
+        const size_t sub_buckets = size_t{1} << sub_bits;
+        if (index < sub_buckets) return index;
+        const auto shift = static_cast<unsigned>(index / sub_buckets) - 1;
+        return static_cast<std::uint64_t>(sub_buckets + index % sub_buckets) << shift;
+    }
+
+    [[nodiscard]] size_t bucket_index(std::uint64_t value) const noexcept
+    {
+        const size_t sub_buckets = size_t{1} << sub_bits;
+        if (value < sub_buckets) return static_cast<size_t>(value);
+        const auto shift = static_cast<unsigned>(std::bit_width(value)) - 1 - sub_bits;
+        return (shift + 1) * sub_buckets + static_cast<size_t>((value >> shift) & (sub_buckets - 1));
+    }
+
+    // Mean value of the bucket, clamped to the recorded range so the extreme buckets stay exact
+    [[nodiscard]] double midpoint(size_t index) const noexcept
+    {
+        const size_t sub_buckets = size_t{1} << sub_bits;
+        const auto lower = static_cast<double>(bucket_lower_bound(index));
+        const double width = index < sub_buckets ? 1.0 : std::ldexp(1.0, static_cast<int>(index / sub_buckets) - 1);
+        return std::clamp(lower + (width - 1.0) / 2.0, static_cast<double>(min()), static_cast<double>(max()));
+    }
+
+private:
+    [[nodiscard]] static size_t bucket_count_for(unsigned precision_bits)
+    {
+        if (precision_bits == 0 || precision_bits > max_precision_bits)
+        {
+            throw std::invalid_argument("Latency histogram precision must be between 1 and 16 bits");
+        }
+        return (64 - precision_bits + 1) * (size_t{1} << precision_bits);
+    }
+
+    void copy_counters(const LatencyHistogram& other, bool with_buckets = true) noexcept
+    {
+        if (with_buckets)
+        {
+            for (size_t i = 0; i < counts.size(); ++i)
+            {
+                counts[i].store(other.counts[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+            }
+        }
+        total.store(other.total.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        value_sum.store(other.value_sum.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        min_value.store(other.min_value.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        max_value.store(other.max_value.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    unsigned sub_bits;
+    std::vector<std::atomic<std::uint64_t>> counts;
+    std::atomic<std::uint64_t> total{0};
+    std::atomic<std::uint64_t> value_sum{0};
+    std::atomic<std::uint64_t> min_value{std::numeric_limits<std::uint64_t>::max()};
+    std::atomic<std::uint64_t> max_value{0};
+};
+
+} // namespace sra
@@ -0,0 +1,337 @@
+/**
+ * @file parallel_profiler.hpp
+ * * @brief Parallel multi-sample profiling on pinned worker threads
+ *
+ * @project Simple Runtime Analyzer
+ *
+ * @author Diego Osorio (ShineKnightDev)
+ *
+ * @copyright Copyright (c) 2025 Diego Osorio (ShineKnightDev)
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <ranges>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "shineknightdev/runtime_analyzer.hpp"
+
+#if defined(__linux__)
+#    include <sched.h>
+#elif defined(_WIN32)
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    include <windows.h>
+#endif
+
+namespace sra
+{
+
+struct ParallelConfig
+{
+    size_t threads = 0;       // 0 uses one worker per available core
+    std::vector<int> cpus{};  // Cores to pin workers to, empty uses the cores the process is allowed to run on
+    bool pin_threads = true;
+};
+
+namespace detail
+{
+
+// Cores this process may run on, which honors taskset/cgroup restrictions and isolated cores handed to it
+[[nodiscard]] inline std::vector<int> available_cpus()
+{
+    std::vector<int> cpus;
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+    {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+        {
+            if (CPU_ISSET(cpu, &set)) { cpus.push_back(cpu); }
+        }
+    }
+#elif defined(_WIN32)
+    DWORD_PTR process_mask = 0;
+    DWORD_PTR system_mask = 0;
+    if (GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask))
+    {
+        for (int cpu = 0; cpu < static_cast<int>(sizeof(DWORD_PTR) * 8); ++cpu)
+        {
+            if (process_mask & (DWORD_PTR{1} << cpu)) { cpus.push_back(cpu); }
+        }
+    }
+#endif
+    if (cpus.empty())
+    {
+        cpus.resize(std::max(1u, std::thread::hardware_concurrency()));
+        std::iota(cpus.begin(), cpus.end(), 0);
+    }
+    return cpus;
+}
+
+inline bool pin_current_thread(int cpu) noexcept
+{
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#elif defined(_WIN32)
+    return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR{1} << cpu) != 0;
+#else
+    static_cast<void>(cpu);
+    return false;
+#endif
+}
+
+[[nodiscard]] inline int current_cpu() noexcept
+{
+#if defined(__linux__)
+    return sched_getcpu();
+#elif defined(_WIN32)
+    return static_cast<int>(GetCurrentProcessorNumber());
+#else
+    return -1;
+#endif
+}
+
+// One deque of sample indices per worker. Owners take from the front, idle workers steal from the back of others
+class WorkStealingQueues
+{
+public:
+    explicit WorkStealingQueues(size_t workers)
+    {
+        queues.reserve(workers);
+        for (size_t i = 0; i < workers; ++i) { queues.push_back(std::make_unique<Queue>()); }
+    }
+
+    void push(size_t worker, size_t task)
+    {
+        auto& queue = *queues[worker];
+        std::scoped_lock lock(queue.mutex);
+        queue.tasks.push_back(task);
+    }
+
+    [[nodiscard]] std::optional<size_t> pop(size_t worker)
+    {
+        {
+            auto& own = *queues[worker];
+            std::scoped_lock lock(own.mutex);
+            if (!own.tasks.empty())
+            {
+                const size_t task = own.tasks.front();
+                own.tasks.pop_front();
+                return task;
+            }
+        }
+
+        for (size_t offset = 1; offset < queues.size(); ++offset)
+        {
+            auto& victim = *queues[(worker + offset) % queues.size()];
+            std::scoped_lock lock(victim.mutex);
+            if (!victim.tasks.empty())
+            {
+                const size_t task = victim.tasks.back();
+                victim.tasks.pop_back();
+                return task;
+            }
+        }
+        return std::nullopt;
+    }
+
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<size_t> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+};
+
+// Measures every sample on the workers. make_measure() gives each worker its own callable, invoked as
+// measure(sample, probes) on the samples that worker takes
+template <ChronoDuration Unit, typename Container, typename MakeMeasure>
+[[nodiscard]] RuntimeProfile<Unit> profile_parallel(const MeasurementPolicy& policy,
+                                                    const ParallelConfig& config,
+                                                    const Container& samples,
+                                                    MakeMeasure&& make_measure)
+{
+    if (std::ranges::empty(samples))
+    {
+        throw std::invalid_argument("Cannot profile runtime with empty samples container");
+    }
+    validate_policy(policy);
+
+    const size_t num_samples = std::ranges::size(samples);
+    const std::vector<int> cpus = config.cpus.empty() ? available_cpus() : config.cpus;
+
+    size_t workers = config.threads != 0 ? config.threads : cpus.size();
+    if (config.pin_threads) { workers = std::min(workers, cpus.size()); }
+    workers = std::clamp<size_t>(workers, 1, num_samples);
+
+    // Largest samples first, dealt round-robin so every worker starts with a similar share of the work
+    std::vector<size_t> order(num_samples);
+    std::iota(order.begin(), order.end(), size_t{0});
+    std::ranges::stable_sort(order, std::greater<>{}, [&samples](size_t index) {
+        return static_cast<size_t>(std::ranges::begin(samples)[index].size());
+    });
+
+    WorkStealingQueues queues(workers);
+    for (size_t i = 0; i < order.size(); ++i) { queues.push(i % workers, order[i]); }
+
+    std::vector<std::optional<SampleMeasurement<Unit>>> results(num_samples);
+    std::atomic<bool> failed = false;
+    std::exception_ptr failure;
+    std::mutex failure_mutex;
+    std::atomic<size_t> pin_failures = 0;
+
+    auto worker_main = [&](size_t worker) {
+        try
+        {
+            if (config.pin_threads && !pin_current_thread(cpus[worker % cpus.size()])) { ++pin_failures; }
+
+            auto probes = open_probes(policy, worker == 0);
+            auto measure = make_measure();
+
+            while (!failed)
+            {
+                const auto index = queues.pop(worker);
+                if (!index) { break; }
+
+                const auto& sample = std::ranges::begin(samples)[*index];
+                SampleMeasurement<Unit> measurement = measure(sample, probes);
+                measurement.sample_size = sample.size();
+                measurement.throughput = detail::sample_throughput(policy, sample);
+                measurement.cpu_id = current_cpu();
+                results[*index] = std::move(measurement);
+            }
+        }
+        catch (...)
+        {
+            std::scoped_lock lock(failure_mutex);
+            if (!failure) { failure = std::current_exception(); }
+            failed = true;
+        }
+    };
+
+    {
+        std::vector<std::jthread> pool;
+        pool.reserve(workers);
+        for (size_t worker = 0; worker < workers; ++worker) { pool.emplace_back(worker_main, worker); }
+    }
+
+    if (failure) { std::rethrow_exception(failure); }
+    if (pin_failures > 0) { std::cerr << "Warning: " << pin_failures << " worker(s) could not be pinned to a core\n"; }
+
+    // Each worker opens its own probes. A probe only some workers could open is dropped, not left as a partial column
+    auto drop_partial = [&results](auto member, std::string_view probe) {
+        const auto opened = std::ranges::count_if(results, [member](const auto& result) {
+            return ((*result).*member).has_value();
+        });
+        if (opened == 0 || static_cast<size_t>(opened) == results.size()) { return; }
+        std::cerr << "Warning: " << probe << " only available on some workers, column dropped\n";
+        for (auto& result : results) { ((*result).*member).reset(); }
+    };
+    drop_partial(&SampleMeasurement<Unit>::counters, "hardware counters");
+    drop_partial(&SampleMeasurement<Unit>::allocations, "allocation tracking");
+
+    RuntimeProfile<Unit> profile;
+    profile.reserve(num_samples);
+    for (auto& result : results) { profile.append(std::move(*result)); }
+
+    return profile;
+}
+
+} // namespace detail
+
+template <ChronoDuration Unit = std::chrono::milliseconds,
+          ClockPolicy Clock = SteadyClock,
+          typename Func,
+          std::ranges::random_access_range Container,
+          typename... Args>
+requires std::ranges::sized_range<Container> && HasSize<std::ranges::range_value_t<Container>> &&
+         std::invocable<Func, const std::ranges::range_value_t<Container>&, Args...> &&
+         std::copy_constructible<std::decay_t<Func>>
+[[nodiscard]] auto profile_runtime_parallel(const MeasurementPolicy& policy,
+                                            const ParallelConfig& config,
+                                            Func&& func,
+                                            const Container& samples,
+                                            Args&&... args)
+{
+    // The callable and the arguments are captured by value, and every worker invokes its own copy of both, so a
+    // stateful functor or mutable lambda is never called from two threads at once
+    auto invoke_func = [func_copy = std::decay_t<Func>(func),
+                        ... captured_args = std::forward<Args>(args)](const auto& sample) mutable {
+        detail::invoke_and_keep(func_copy, sample, std::forward<Args>(captured_args)...);
+    };
+
+    return detail::profile_parallel<Unit>(policy, config, samples, [&policy, &invoke_func] {
+        return [&policy, local_invoke = invoke_func](const auto& sample, detail::MeasurementProbes& probes) mutable {
+            using Sample = std::remove_cvref_t<decltype(sample)>;
+            detail::SampleCalls<decltype(local_invoke), Sample> calls{local_invoke, sample};
+            return detail::measure_sample<Unit, Clock>(policy, calls, &probes);
+        };
+    });
+}
+
+// Fixture overload: every worker keeps its own copy of the fixture and its own pool of inputs
+template <ChronoDuration Unit = std::chrono::milliseconds,
+          ClockPolicy Clock = SteadyClock,
+          typename Body,
+          typename Setup,
+          typename Teardown,
+          std::ranges::random_access_range Container>
+requires std::ranges::sized_range<Container> && HasSize<std::ranges::range_value_t<Container>> &&
+         std::invocable<Body&, std::ranges::range_value_t<Container>&>
+[[nodiscard]] auto profile_runtime_parallel(const MeasurementPolicy& policy,
+                                            const ParallelConfig& config,
+                                            const Fixture<Body, Setup, Teardown>& fixture,
+                                            const Container& samples)
+{
+    using Sample = std::ranges::range_value_t<Container>;
+
+    return detail::profile_parallel<Unit>(policy, config, samples, [&policy, &fixture] {
+        return [&policy, local = fixture, inputs = std::vector<Sample>{}](
+                   const Sample& sample, detail::MeasurementProbes& probes) mutable {
+            detail::FixtureCalls<Fixture<Body, Setup, Teardown>, Sample, Sample> calls{local, sample, inputs};
+            return detail::measure_sample<Unit, Clock>(policy, calls, &probes);
+        };
+    });
+}
+
+template <ChronoDuration Unit = std::chrono::milliseconds,
+          ClockPolicy Clock = SteadyClock,
+          typename Func,
+          std::ranges::random_access_range Container,
+          typename... Args>
+requires std::ranges::sized_range<Container> && HasSize<std::ranges::range_value_t<Container>> &&
+         std::invocable<Func, const std::ranges::range_value_t<Container>&, Args...>
+[[nodiscard]] auto
+profile_runtime_parallel(const ParallelConfig& config, Func&& func, const Container& samples, Args&&... args)
+{
+    return profile_runtime_parallel<Unit, Clock>(
+        MeasurementPolicy{}, config, std::forward<Func>(func), samples, std::forward<Args>(args)...);
+}
+
+} // namespace sra
@@ -0,0 +1,722 @@
+/**
+ * @file process_isolation.hpp
+ * * @brief Measurement of each sample in a forked child process, with crash and timeout reporting
+ *
+ * @project Simple Runtime Analyzer
+ *
+ * @author Diego Osorio (ShineKnightDev)
+ *
+ * @copyright Copyright (c) 2025 Diego Osorio (ShineKnightDev)
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "shineknightdev/runtime_analyzer.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#    define SRA_HAS_FORK 1
+#    include <cerrno>
+#    include <csignal>
+#    include <poll.h>
+#    include <sys/resource.h>
+#    include <sys/wait.h>
+#    include <unistd.h>
+#else
+#    define SRA_HAS_FORK 0
+#endif
+
+namespace sra
+{
+
+struct IsolationConfig
+{
+    // Wall-clock limit of each child process, zero waits for as long as it runs
+    std::chrono::nanoseconds timeout = std::chrono::nanoseconds::zero();
+
+    // Forks one child per timed region instead of one per sample, so no repetition sees the state left by another
+    bool fork_per_repetition = false;
+};
+
+enum class SampleFailureKind
+{
+    crashed,   // The child was killed by a signal, e.g. SIGSEGV or SIGABRT
+    timed_out, // The child ran past IsolationConfig::timeout and was killed
+    threw,     // The measured code threw an exception
+    exited     // The child exited without sending its measurement, e.g. through std::exit
+};
+
+[[nodiscard]] constexpr std::string_view to_string(SampleFailureKind kind) noexcept
+{
+    switch (kind)
+    {
+        case SampleFailureKind::crashed: return "crashed";
+        case SampleFailureKind::timed_out: return "timed out";
+        case SampleFailureKind::threw: return "threw";
+        case SampleFailureKind::exited: return "exited";
+    }
+    return "unknown";
+}
+
+// A sample whose measurement was lost, the rest of the sweep goes on without it
+struct SampleFailure
+{
+    size_t sample_size = 0;
+    SampleFailureKind kind = SampleFailureKind::crashed;
+    int code = 0;          // Signal number of a crash or timeout, exit status of an early exit
+    std::string message{}; // Signal description, exception message, exit status or why the record was unreadable
+};
+
+template <ChronoDuration Unit>
+struct IsolatedProfile
+{
+    RuntimeProfile<Unit> profile; // Samples that completed, in sample order
+    std::vector<SampleFailure> failures;
+};
+
+namespace detail
+{
+
+inline constexpr std::uint32_t isolation_record_magic = 0x49415253; // "SRAI"
+
+enum class RecordStatus : std::uint8_t
+{
+    measured,
+    threw
+};
+
+struct BucketCount
+{
+    std::uint64_t index = 0;
+    std::uint64_t count = 0;
+};
+
+// Record a child sends to its parent. Both run the same executable, so values are copied as they are in memory
+class RecordWriter
+{
+public:
+    template <typename T>
+    requires std::is_trivially_copyable_v<T>
+    void put(const T& value)
+    {
+        const auto* first = reinterpret_cast<const std::byte*>(&value);
+        bytes.insert(bytes.end(), first, first + sizeof(T));
+    }
+
+    template <typename T>
+    requires std::is_trivially_copyable_v<T>
+    void put_range(std::span<const T> values)
+    {
+        put<std::uint64_t>(values.size());
+        const auto* first = reinterpret_cast<const std::byte*>(values.data());
+        bytes.insert(bytes.end(), first, first + values.size_bytes());
+    }
+
+    template <typename T>
+    void put_optional(const std::optional<T>& value)
+    {
+        put<std::uint8_t>(value.has_value());
+        if (value) { put(*value); }
+    }
+
+    [[nodiscard]] std::vector<std::byte>& data() noexcept { return bytes; }
+
+private:
+    std::vector<std::byte> bytes;
+};
+
+class RecordReader
+{
+public:
+    explicit RecordReader(std::span<const std::byte> bytes) : bytes(bytes) {}
+
+    template <typename T>
+    requires std::is_trivially_copyable_v<T>
+    [[nodiscard]] T get()
+    {
+        T value;
+        std::memcpy(&value, take(sizeof(T)).data(), sizeof(T));
+        return value;
+    }
+
+    template <typename T>
+    requires std::is_trivially_copyable_v<T>
+    [[nodiscard]] std::vector<T> get_range()
+    {
+        const auto count = get<std::uint64_t>();
+        if (count > bytes.size() / sizeof(T)) { throw truncated(); }
+        std::vector<T> values(static_cast<size_t>(count));
+        std::memcpy(values.data(), take(values.size() * sizeof(T)).data(), values.size() * sizeof(T));
+        return values;
+    }
+
+    template <typename T>
+    [[nodiscard]] std::optional<T> get_optional()
+    {
+        if (get<std::uint8_t>() == 0) return std::nullopt;
+        return get<T>();
+    }
+
+private:
+    [[nodiscard]] static std::runtime_error truncated() { return std::runtime_error("Truncated isolation record"); }
+
+    [[nodiscard]] std::span<const std::byte> take(size_t size)
+    {
+        if (size > bytes.size()) { throw truncated(); }
+        const auto taken = bytes.first(size);
+        bytes = bytes.subspan(size);
+        return taken;
+    }
+
+    std::span<const std::byte> bytes;
+};
+
+template <ChronoDuration Unit>
+[[nodiscard]] std::vector<std::byte> encode_measurement(const SampleMeasurement<Unit>& measurement)
+{
+    RecordWriter writer;
+    writer.put(isolation_record_magic);
+    writer.put(RecordStatus::measured);
+    writer.put<std::uint64_t>(measurement.sample_size);
+    writer.put_range(std::span(measurement.repetitions));
+    writer.put_range(std::span(measurement.timeline));
+    writer.put_optional(measurement.counters);
+    writer.put_optional(measurement.allocations);
+    writer.put_optional(measurement.cache_mode);
+    writer.put_optional(measurement.process_usage);
+
+    writer.put<std::uint8_t>(measurement.histogram.has_value());
+    if (const auto& histogram = measurement.histogram)
+    {
+        // Only the non-empty buckets
+        std::vector<BucketCount> buckets;
+        for (size_t i = 0; i < histogram->bucket_count(); ++i)
+        {
+            if (const auto count = histogram->count_at(i)) { buckets.push_back({i, count}); }
+        }
+        writer.put<std::uint32_t>(histogram->precision_bits());
+        writer.put(histogram->min());
+        writer.put(histogram->max());
+        writer.put(histogram->sum());
+        writer.put_range(std::span<const BucketCount>(buckets));
+    }
+    return std::move(writer.data());
+}
+
+[[nodiscard]] inline std::vector<std::byte> encode_exception(std::string_view message)
+{
+    RecordWriter writer;
+    writer.put(isolation_record_magic);
+    writer.put(RecordStatus::threw);
+    writer.put_range(std::span(message.data(), message.size()));
+    return std::move(writer.data());
+}
+
+template <ChronoDuration Unit>
+[[nodiscard]] SampleMeasurement<Unit> decode_measurement(RecordReader& reader)
+{
+    SampleMeasurement<Unit> measurement;
+    measurement.sample_size = static_cast<size_t>(reader.get<std::uint64_t>());
+    measurement.repetitions = reader.get_range<Unit>();
+    measurement.timeline = reader.get_range<TimedSpan>();
+    measurement.counters = reader.get_optional<HardwareCounters>();
+    measurement.allocations = reader.get_optional<AllocationStats>();
+    measurement.cache_mode = reader.get_optional<CacheMode>();
+    measurement.process_usage = reader.get_optional<ProcessUsage>();
+
+    if (reader.get<std::uint8_t>() != 0)
+    {
+        auto& histogram = measurement.histogram.emplace(reader.get<std::uint32_t>());
+        const auto minimum = reader.get<std::uint64_t>();
+        const auto maximum = reader.get<std::uint64_t>();
+        const auto sum = reader.get<std::uint64_t>();
+        for (const auto& [index, count] : reader.get_range<BucketCount>())
+        {
+            if (index >= histogram.bucket_count()) { throw std::runtime_error("Invalid isolation record"); }
+            histogram.record(histogram.bucket_lower_bound(static_cast<size_t>(index)), count);
+        }
+        histogram.restore_totals(minimum, maximum, sum);
+    }
+    return measurement;
+}
+
+// Measurement of one child, or why there is none
+template <ChronoDuration Unit>
+struct IsolatedRun
+{
+    std::optional<SampleMeasurement<Unit>> measurement{};
+    std::optional<SampleFailure> failure{};
+};
+
+// A record cut short or garbled, e.g. by a child that exited while writing it, fails only its own sample
+template <ChronoDuration Unit>
+[[nodiscard]] IsolatedRun<Unit> parse_record(std::span<const std::byte> bytes, int exit_code)
+{
+    try
+    {
+        RecordReader reader(bytes);
+        if (reader.get<std::uint32_t>() != isolation_record_magic)
+        {
+            throw std::runtime_error("Invalid isolation record");
+        }
+        if (reader.get<RecordStatus>() == RecordStatus::threw)
+        {
+            const auto message = reader.get_range<char>();
+            return {.failure = SampleFailure{.kind = SampleFailureKind::threw,
+                                             .message = std::string(message.begin(), message.end())}};
+        }
+        return {.measurement = decode_measurement<Unit>(reader)};
+    }
+    catch (const std::exception& error)
+    {
+        return {.failure = SampleFailure{
+                    .kind = SampleFailureKind::exited, .code = exit_code, .message = error.what()}};
+    }
+}
+
+#if SRA_HAS_FORK
+
+struct UsageSnapshot
+{
+    std::size_t max_rss_bytes = 0;
+    std::uint64_t voluntary_switches = 0;
+    std::uint64_t involuntary_switches = 0;
+};
+
+[[nodiscard]] inline UsageSnapshot current_usage() noexcept
+{
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+#    if defined(__APPLE__)
+    const auto rss_bytes = static_cast<std::size_t>(usage.ru_maxrss);
+#    else
+    const auto rss_bytes = static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+#    endif
+    return {rss_bytes, static_cast<std::uint64_t>(usage.ru_nvcsw), static_cast<std::uint64_t>(usage.ru_nivcsw)};
+}
+
+inline void write_all(int fd, std::span<const std::byte> bytes) noexcept
+{
+    while (!bytes.empty())
+    {
+        const auto written = ::write(fd, bytes.data(), bytes.size());
+        if (written < 0 && errno == EINTR) { continue; }
+        if (written <= 0) { return; }
+        bytes = bytes.subspan(static_cast<size_t>(written));
+    }
+}
+
+// Child side: measures, sends the record and exits without running the destructors and exit handlers of the parent
+template <ChronoDuration Unit, typename Produce>
+[[noreturn]] void run_child(int fd, Produce& produce) noexcept
+{
+    int status = 0;
+    std::vector<std::byte> record;
+    try
+    {
+        const auto before = current_usage();
+        auto measurement = produce();
+        const auto after = current_usage();
+        measurement.process_usage = ProcessUsage{
+            .max_rss_bytes = after.max_rss_bytes,
+            .voluntary_switches = after.voluntary_switches - before.voluntary_switches,
+            .involuntary_switches = after.involuntary_switches - before.involuntary_switches};
+        record = encode_measurement(measurement);
+    }
+    catch (const std::exception& error)
+    {
+        record = encode_exception(error.what());
+        status = 1;
+    }
+    catch (...)
+    {
+        record = encode_exception("unknown exception");
+        status = 1;
+    }
+
+    std::cout.flush();
+    std::cerr.flush();
+    std::fflush(nullptr);
+    write_all(fd, record);
+    ::close(fd);
+    ::_exit(status);
+}
+
+// Parent side: reads the record of the child until it exits, killing it when the timeout passes
+template <ChronoDuration Unit, typename Produce>
+[[nodiscard]] IsolatedRun<Unit> run_isolated(const IsolationConfig& config, Produce&& produce)
+{
+    // Unflushed output would otherwise be written again by the child
+    std::cout.flush();
+    std::cerr.flush();
+    std::fflush(nullptr);
+
+    int fds[2];
+    if (::pipe(fds) != 0) { throw std::runtime_error("Could not create a pipe for an isolated sample"); }
+
+    const pid_t child = ::fork();
+    if (child < 0)
+    {
+        ::close(fds[0]);
+        ::close(fds[1]);
+        throw std::runtime_error("Could not fork a process for an isolated sample");
+    }
+    if (child == 0)
+    {
+        ::close(fds[0]);
+        run_child<Unit>(fds[1], produce);
+    }
+    ::close(fds[1]);
+
+    const bool has_timeout = config.timeout > std::chrono::nanoseconds::zero();
+    const auto deadline = std::chrono::steady_clock::now() + config.timeout;
+    std::vector<std::byte> record;
+    std::array<std::byte, 4096> chunk;
+    bool timed_out = false;
+    while (true)
+    {
+        int wait_ms = -1;
+        if (has_timeout)
+        {
+            const auto remaining = deadline - std::chrono::steady_clock::now();
+            if (remaining <= std::chrono::nanoseconds::zero())
+            {
+                timed_out = true;
+                break;
+            }
+            const auto remaining_ms = std::chrono::ceil<std::chrono::milliseconds>(remaining).count();
+            wait_ms = static_cast<int>(std::min<std::int64_t>(remaining_ms, 1000));
+        }
+
+        pollfd poll_fd{.fd = fds[0], .events = POLLIN, .revents = 0};
+        const int ready = ::poll(&poll_fd, 1, wait_ms);
+        if (ready < 0 && errno != EINTR) { break; }
+        if (ready <= 0) { continue; }
+
+        const auto received = ::read(fds[0], chunk.data(), chunk.size());
+        if (received < 0 && errno == EINTR) { continue; }
+        if (received <= 0) { break; }
+        record.insert(record.end(), chunk.begin(), chunk.begin() + received);
+    }
+    ::close(fds[0]);
+
+    if (timed_out) { ::kill(child, SIGKILL); }
+    int status = 0;
+    while (::waitpid(child, &status, 0) < 0 && errno == EINTR) {}
+
+    if (timed_out)
+    {
+        return {.failure = SampleFailure{.kind = SampleFailureKind::timed_out,
+                                         .code = SIGKILL,
+                                         .message = "killed after the isolation timeout"}};
+    }
+    if (WIFSIGNALED(status))
+    {
+        const int signal = WTERMSIG(status);
+        return {.failure = SampleFailure{
+                    .kind = SampleFailureKind::crashed, .code = signal, .message = ::strsignal(signal)}};
+    }
+    const int code = WIFEXITED(status) ? WEXITSTATUS(status) : 0;
+    if (record.empty())
+    {
+        return {.failure = SampleFailure{.kind = SampleFailureKind::exited,
+                                         .code = code,
+                                         .message = "exit status " + std::to_string(code)}};
+    }
+    return parse_record<Unit>(record, code);
+}
+
+#else
+
+// Without fork the sample is measured in this process: exceptions are still reported, crashes and timeouts are not
+template <ChronoDuration Unit, typename Produce>
+[[nodiscard]] IsolatedRun<Unit> run_isolated(const IsolationConfig&, Produce&& produce)
+{
+    try
+    {
+        return {.measurement = produce()};
+    }
+    catch (const std::exception& error)
+    {
+        return {.failure = SampleFailure{.kind = SampleFailureKind::threw, .message = error.what()}};
+    }
+    catch (...)
+    {
+        return {.failure = SampleFailure{.kind = SampleFailureKind::threw, .message = "unknown exception"}};
+    }
+}
+
+#endif
+
+// Combines the children of one sample measured with a child per timed region
+template <ChronoDuration Unit>
+class RepetitionPool
+{
+public:
+    void add(SampleMeasurement<Unit>&& part)
+    {
+        ++parts;
+        auto& runs = total.repetitions;
+        runs.insert(runs.end(), part.repetitions.begin(), part.repetitions.end());
+        total.timeline.insert(total.timeline.end(), part.timeline.begin(), part.timeline.end());
+        total.cache_mode = part.cache_mode;
+
+        if (part.histogram)
+        {
+            if (total.histogram) { total.histogram->merge(*part.histogram); }
+            else { total.histogram = std::move(part.histogram); }
+        }
+        if (part.counters)
+        {
+            for (size_t c = 0; c < counter_fields.size(); ++c)
+            {
+                if (const auto value = (*part.counters).*counter_fields[c].member)
+                {
+                    counter_sums[c] += *value;
+                    ++counter_parts[c];
+                }
+            }
+            has_counters = true;
+        }
+        if (part.allocations)
+        {
+            auto& stats = total.allocations ? *total.allocations : total.allocations.emplace(AllocationStats{});
+            stats.allocations += part.allocations->allocations;
+            stats.bytes_allocated += part.allocations->bytes_allocated;
+            stats.peak_live_bytes = std::max(stats.peak_live_bytes, part.allocations->peak_live_bytes);
+        }
+        if (part.process_usage)
+        {
+            auto& usage = total.process_usage ? *total.process_usage : total.process_usage.emplace(ProcessUsage{});
+            usage.max_rss_bytes = std::max(usage.max_rss_bytes, part.process_usage->max_rss_bytes);
+            usage.voluntary_switches += part.process_usage->voluntary_switches;
+            usage.involuntary_switches += part.process_usage->involuntary_switches;
+        }
+    }
+
+    // Counters and allocations are averages per call in every child, so they are averaged over the children
+    [[nodiscard]] SampleMeasurement<Unit> take()
+    {
+        if (has_counters)
+        {
+            auto& counters = total.counters.emplace();
+            for (size_t c = 0; c < counter_fields.size(); ++c)
+            {
+                if (counter_parts[c] > 0)
+                {
+                    counters.*counter_fields[c].member = counter_sums[c] / static_cast<double>(counter_parts[c]);
+                }
+            }
+        }
+        if (total.allocations && parts > 0)
+        {
+            total.allocations->allocations /= static_cast<double>(parts);
+            total.allocations->bytes_allocated /= static_cast<double>(parts);
+        }
+        return std::move(total);
+    }
+
+private:
+    SampleMeasurement<Unit> total;
+    size_t parts = 0;
+    bool has_counters = false;
+    std::array<double, counter_fields.size()> counter_sums{};
+    std::array<size_t, counter_fields.size()> counter_parts{};
+};
+
+// Measures one sample with a child per timed region, following the repetition and auto-repeat rules of the policy
+template <ChronoDuration Unit, typename Measure>
+[[nodiscard]] IsolatedRun<Unit>
+measure_per_repetition(const MeasurementPolicy& policy, const IsolationConfig& config, Measure& measure)
+{
+    auto child_policy = policy;
+    child_policy.repetitions = 1;
+    child_policy.auto_repeat = false;
+
+    RepetitionPool<Unit> pool;
+    RunningMoments moments;
+    const auto budget_start = std::chrono::steady_clock::now();
+    while (true)
+    {
+        auto run = run_isolated<Unit>(config, [&] { return measure(child_policy); });
+        if (!run.measurement) return run;
+
+        const auto& part = *run.measurement;
+        if (part.histogram) { moments.add(part.histogram->mean()); }
+        else if (!part.repetitions.empty()) { moments.add(static_cast<double>(part.repetitions.front().count())); }
+        pool.add(std::move(*run.measurement));
+
+        if (moments.count < policy.repetitions) { continue; }
+        if (!policy.auto_repeat || moments.count >= policy.max_repetitions) { break; }
+        if (moments.relative_confidence_interval() <= policy.target_relative_ci) { break; }
+        if (std::chrono::steady_clock::now() - budget_start >= policy.time_budget) { break; }
+    }
+    return {.measurement = pool.take()};
+}
+
+// Runs `measure(policy, sample, probes)` in a child process for every sample the sink has not completed
+template <ChronoDuration Unit, MeasurementSink<Unit> Sink, typename Container, typename Measure>
+[[nodiscard]] std::vector<SampleFailure> profile_isolated(const MeasurementPolicy& policy,
+                                                          const IsolationConfig& config,
+                                                          Sink& sink,
+                                                          const Container& samples,
+                                                          Measure&& measure)
+{
+    if (std::ranges::empty(samples))
+    {
+        throw std::invalid_argument("Cannot profile runtime with empty samples container");
+    }
+    validate_policy(policy);
+
+#if !SRA_HAS_FORK
+    std::cerr << "Warning: process isolation requires fork, measuring in this process without timeouts\n";
+#endif
+
+    // Reports unavailable probes once, every child then opens its own without warnings
+    static_cast<void>(open_probes(policy));
+
+    // Fixed before forking, so the timelines of all children share the trace epoch of this process
+    if (policy.record_timeline) { static_cast<void>(trace_epoch()); }
+
+    std::vector<SampleFailure> failures;
+    for (const auto& sample : samples)
+    {
+        if (sink.completed(sample.size())) { continue; }
+
+        auto measure_sample_in = [&measure, &sample](const MeasurementPolicy& child_policy) {
+            auto probes = open_probes(child_policy, false);
+            return measure(child_policy, sample, probes);
+        };
+        auto run = config.fork_per_repetition
+                       ? measure_per_repetition<Unit>(policy, config, measure_sample_in)
+                       : run_isolated<Unit>(config, [&] { return measure_sample_in(policy); });
+
+        if (run.measurement)
+        {
+            run.measurement->sample_size = sample.size();
+            run.measurement->throughput = sample_throughput(policy, sample);
+            sink.push(std::move(*run.measurement));
+            continue;
+        }
+
+        auto& failure = failures.emplace_back(std::move(*run.failure));
+        failure.sample_size = sample.size();
+        std::cerr << "Warning: sample of size " << failure.sample_size << " " << to_string(failure.kind) << " ("
+                  << failure.message << "), skipped\n";
+    }
+    return failures;
+}
+
+} // namespace detail
+
+// Measures every sample in a forked child process, so no sample sees the heap, caches of lazily built state or
+// threads left by the previous ones. A sample that crashes, throws or runs past the timeout is skipped and reported
+// in the returned failures instead of ending the sweep
+template <ChronoDuration Unit = std::chrono::milliseconds,
+          ClockPolicy Clock = SteadyClock,
+          MeasurementSink<Unit> Sink,
+          typename Func,
+          std::ranges::range Container,
+          typename... Args>
+requires HasSize<std::ranges::range_value_t<Container>> &&
+         std::invocable<Func, const std::ranges::range_value_t<Container>&, Args...>
+std::vector<SampleFailure> profile_runtime_isolated(const MeasurementPolicy& policy,
+                                                    const IsolationConfig& config,
+                                                    Sink& sink,
+                                                    Func&& func,
+                                                    const Container& samples,
+                                                    Args&&... args)
+{
+    // Calibrated once here instead of in every child
+    static_cast<void>(timer_overhead<Clock>());
+
+    // Capture arguments safely
+    auto invoke_func = [&func, ... captured_args = std::forward<Args>(args)](const auto& sample) mutable {
+        detail::invoke_and_keep(func, sample, std::forward<Args>(captured_args)...);
+    };
+
+    return detail::profile_isolated<Unit>(
+        policy, config, sink, samples,
+        [&invoke_func](const MeasurementPolicy& child_policy, const auto& sample, detail::MeasurementProbes& probes) {
+            using Sample = std::remove_cvref_t<decltype(sample)>;
+            detail::SampleCalls<decltype(invoke_func), Sample> calls{invoke_func, sample};
+            return detail::measure_sample<Unit, Clock>(child_policy, calls, &probes);
+        });
+}
+
+template <ChronoDuration Unit = std::chrono::milliseconds,
+          ClockPolicy Clock = SteadyClock,
+          typename Func,
+          std::ranges::range Container,
+          typename... Args>
+requires HasSize<std::ranges::range_value_t<Container>> &&
+         std::invocable<Func, const std::ranges::range_value_t<Container>&, Args...>
+[[nodiscard]] IsolatedProfile<Unit> profile_runtime_isolated(const MeasurementPolicy& policy,
+                                                             const IsolationConfig& config,
+                                                             Func&& func,
+                                                             const Container& samples,
+                                                             Args&&... args)
+{
+    IsolatedProfile<Unit> result;
+    result.profile.reserve(std::ranges::size(samples));
+
+    detail::ProfileSink<Unit> sink{result.profile};
+    result.failures = profile_runtime_isolated<Unit, Clock>(
+        policy, config, sink, std::forward<Func>(func), samples, std::forward<Args>(args)...);
+
+    return result;
+}
+
+// Fixture overload: each child sets up its own pool of inputs
+template <ChronoDuration Unit = std::chrono::milliseconds,
+          ClockPolicy Clock = SteadyClock,
+          typename Body,
+          typename Setup,
+          typename Teardown,
+          std::ranges::range Container>
+requires HasSize<std::ranges::range_value_t<Container>> &&
+         std::invocable<Body&, std::ranges::range_value_t<Container>&>
+[[nodiscard]] IsolatedProfile<Unit> profile_runtime_isolated(const MeasurementPolicy& policy,
+                                                             const IsolationConfig& config,
+                                                             Fixture<Body, Setup, Teardown> fixture,
+                                                             const Container& samples)
+{
+    using Sample = std::ranges::range_value_t<Container>;
+
+    static_cast<void>(timer_overhead<Clock>());
+
+    IsolatedProfile<Unit> result;
+    result.profile.reserve(std::ranges::size(samples));
+
+    detail::ProfileSink<Unit> sink{result.profile};
+    result.failures = detail::profile_isolated<Unit>(
+        policy, config, sink, samples,
+        [&fixture](const MeasurementPolicy& child_policy, const Sample& sample, detail::MeasurementProbes& probes) {
+            std::vector<Sample> inputs;
+            detail::FixtureCalls<Fixture<Body, Setup, Teardown>, Sample, Sample> calls{fixture, sample, inputs};
+            return detail::measure_sample<Unit, Clock>(child_policy, calls, &probes);
+        });
+
+    return result;
+}
+
+} // namespace sra
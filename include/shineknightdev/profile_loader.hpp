@@ -0,0 +1,768 @@
+/**
+ * @file profile_loader.hpp
+ * * @brief Loading saved reports back into runtime profiles and merging them
+ *
+ * @project Simple Runtime Analyzer
+ *
+ * @author Diego Osorio (ShineKnightDev)
+ *
+ * @copyright Copyright (c) 2025 Diego Osorio (ShineKnightDev)
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "shineknightdev/binary_profile.hpp"
+#include "shineknightdev/complexity_analyzer.hpp"
+#include "shineknightdev/runtime_analyzer.hpp"
+#include "shineknightdev/sample_archive.hpp"
+
+namespace sra
+{
+
+namespace detail
+{
+
+[[nodiscard]] inline std::runtime_error report_error(const std::filesystem::path& filename, const std::string& reason)
+{
+    return std::runtime_error("Error: " + filename.string() + " is not a valid report (" + reason + ")");
+}
+
+// The whole text must be the number, as written by the report writers
+template <typename T>
+[[nodiscard]] std::optional<T> parse_number(std::string_view text) noexcept
+{
+    T value{};
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (error != std::errc{} || end != text.data() + text.size()) return std::nullopt;
+    return value;
+}
+
+// Seconds in one unit of a time_unit symbol, the inverse of get_unit_symbol
+[[nodiscard]] inline std::optional<double> unit_seconds(std::string_view symbol) noexcept
+{
+    if (symbol == "ns") return 1e-9;
+    if (symbol == "μs" || symbol == "us") return 1e-6;
+    if (symbol == "ms") return 1e-3;
+    if (symbol == "s") return 1.0;
+    if (symbol == "min") return 60.0;
+    if (symbol == "h") return 3600.0;
+    return std::nullopt;
+}
+
+// Factor from a time_unit symbol to Unit, like the RuntimeProfile conversion constructor
+template <ChronoDuration Unit>
+[[nodiscard]] std::optional<double> unit_factor(std::string_view symbol) noexcept
+{
+    const auto seconds = unit_seconds(symbol);
+    if (!seconds) return std::nullopt;
+    return *seconds * static_cast<double>(Unit::period::den) / static_cast<double>(Unit::period::num);
+}
+
+// Integral times in the unit of the profile are read exactly, anything else through double like duration_cast
+template <ChronoDuration Unit>
+[[nodiscard]] std::optional<Unit> parse_time(std::string_view text, std::string_view symbol) noexcept
+{
+    using Rep = typename Unit::rep;
+    if constexpr (std::is_integral_v<Rep>)
+    {
+        if (symbol == get_unit_symbol<Unit>())
+        {
+            if (const auto exact = parse_number<Rep>(text)) return Unit(*exact);
+        }
+    }
+
+    const auto value = parse_number<double>(text);
+    const auto factor = unit_factor<Unit>(symbol);
+    if (!value || !factor) return std::nullopt;
+    return Unit(static_cast<Rep>(*value * *factor));
+}
+
+// Columns a loader understands, every other column (sample_id, residual) is skipped
+enum class ReportField
+{
+    ignored,
+    time_unit,
+    time_value,
+    sample_size,
+    counter,
+    allocations,
+    bytes_allocated,
+    peak_live_bytes,
+    cpu_id,
+    cache_mode,
+    max_rss_bytes,
+    voluntary_switches,
+    involuntary_switches,
+    items,
+    bytes
+};
+
+struct FieldId
+{
+    ReportField kind = ReportField::ignored;
+    size_t counter = 0; // Index into counter_fields
+};
+
+[[nodiscard]] inline FieldId field_id(std::string_view name) noexcept
+{
+    if (name == "time_unit") return {ReportField::time_unit};
+    if (name == "time_value") return {ReportField::time_value};
+    if (name == "sample_size") return {ReportField::sample_size};
+    if (name == "allocations") return {ReportField::allocations};
+    if (name == "bytes_allocated") return {ReportField::bytes_allocated};
+    if (name == "peak_live_bytes") return {ReportField::peak_live_bytes};
+    if (name == "cpu_id") return {ReportField::cpu_id};
+    if (name == "cache_mode") return {ReportField::cache_mode};
+    if (name == "max_rss_bytes") return {ReportField::max_rss_bytes};
+    if (name == "voluntary_switches") return {ReportField::voluntary_switches};
+    if (name == "involuntary_switches") return {ReportField::involuntary_switches};
+    if (name == "items") return {ReportField::items};
+    if (name == "bytes") return {ReportField::bytes};
+    for (size_t i = 0; i < counter_fields.size(); ++i)
+    {
+        if (name == counter_fields[i].name) return {ReportField::counter, i};
+    }
+    return {};
+}
+
+// Fields of one report row, viewing the report text until the row is added to the profile
+struct ReportRow
+{
+    std::string_view time_unit;
+    std::string_view time_value;
+    std::string_view sample_size;
+    std::array<std::string_view, counter_fields.size()> counters{};
+    std::string_view allocations;
+    std::string_view bytes_allocated;
+    std::string_view peak_live_bytes;
+    std::string_view cpu_id;
+    std::string_view cache_mode;
+    std::string_view max_rss_bytes;
+    std::string_view voluntary_switches;
+    std::string_view involuntary_switches;
+    std::string_view items;
+    std::string_view bytes;
+    bool has_counters = false;
+    bool has_allocations = false;
+    bool has_usage = false;
+
+    void set(FieldId field, std::string_view value) noexcept
+    {
+        switch (field.kind)
+        {
+            case ReportField::ignored: break;
+            case ReportField::time_unit: time_unit = value; break;
+            case ReportField::time_value: time_value = value; break;
+            case ReportField::sample_size: sample_size = value; break;
+            case ReportField::counter:
+                counters[field.counter] = value;
+                has_counters = true;
+                break;
+            case ReportField::allocations:
+                allocations = value;
+                has_allocations = true;
+                break;
+            case ReportField::bytes_allocated: bytes_allocated = value; break;
+            case ReportField::peak_live_bytes: peak_live_bytes = value; break;
+            case ReportField::cpu_id: cpu_id = value; break;
+            case ReportField::cache_mode: cache_mode = value; break;
+            case ReportField::max_rss_bytes:
+                max_rss_bytes = value;
+                has_usage = true;
+                break;
+            case ReportField::voluntary_switches: voluntary_switches = value; break;
+            case ReportField::involuntary_switches: involuntary_switches = value; break;
+            case ReportField::items: items = value; break;
+            case ReportField::bytes: bytes = value; break;
+        }
+    }
+};
+
+// Appends report rows to a profile. Reports hold the median of each sample, which becomes its only repetition
+template <ChronoDuration Unit>
+class ProfileBuilder
+{
+public:
+    explicit ProfileBuilder(const std::filesystem::path& filename) : filename(filename) {}
+
+    void add(const ReportRow& row)
+    {
+        const size_t sample = profile.size() + 1;
+        auto invalid = [this, sample](const std::string& reason) {
+            return report_error(filename, "sample " + std::to_string(sample) + " " + reason);
+        };
+
+        const auto size = parse_number<size_t>(row.sample_size);
+        const auto time = parse_time<Unit>(row.time_value, row.time_unit);
+        if (!size) { throw invalid("has no valid sample_size"); }
+        if (!time) { throw invalid("has no valid time_value or time_unit"); }
+        if (time_unit.empty()) { time_unit = row.time_unit; }
+
+        profile.sample_sizes.push_back(*size);
+        profile.raw_durations.push_back(*time);
+        profile.repetitions.push_back({*time});
+
+        // Empty fields and nulls are metrics that were not available
+        auto metric = [&invalid](std::string_view text, std::string_view name) -> std::optional<double> {
+            if (text.empty() || text == "null") return std::nullopt;
+            const auto value = parse_number<double>(text);
+            if (!value) { throw invalid("has an invalid " + std::string(name)); }
+            return value;
+        };
+
+        if (row.has_counters)
+        {
+            auto& counters = profile.counters.emplace_back();
+            for (size_t i = 0; i < counter_fields.size(); ++i)
+            {
+                counters.*counter_fields[i].member = metric(row.counters[i], counter_fields[i].name);
+            }
+        }
+        if (row.has_allocations)
+        {
+            profile.allocations.push_back(
+                {.allocations = metric(row.allocations, "allocations").value_or(0.0),
+                 .bytes_allocated = metric(row.bytes_allocated, "bytes_allocated").value_or(0.0),
+                 .peak_live_bytes = parse_number<size_t>(row.peak_live_bytes).value_or(0)});
+        }
+        if (!row.cpu_id.empty())
+        {
+            const auto cpu = parse_number<int>(row.cpu_id);
+            if (!cpu) { throw invalid("has an invalid cpu_id"); }
+            profile.cpu_ids.push_back(*cpu);
+        }
+        if (row.has_usage)
+        {
+            const auto max_rss = parse_number<size_t>(row.max_rss_bytes);
+            const auto voluntary = parse_number<std::uint64_t>(row.voluntary_switches);
+            const auto involuntary = parse_number<std::uint64_t>(row.involuntary_switches);
+            if (!max_rss || !voluntary || !involuntary) { throw invalid("has invalid process usage"); }
+            profile.process_usage.push_back(
+                {.max_rss_bytes = *max_rss, .voluntary_switches = *voluntary, .involuntary_switches = *involuntary});
+        }
+        if (!row.cache_mode.empty())
+        {
+            const auto mode = parse_cache_mode(row.cache_mode);
+            if (!mode) { throw invalid("has an invalid cache_mode"); }
+            profile.cache_modes.push_back(*mode);
+        }
+        if (!row.items.empty())
+        {
+            const auto items = parse_number<std::uint64_t>(row.items);
+            const auto bytes = parse_number<std::uint64_t>(row.bytes);
+            if (!items || !bytes) { throw invalid("has invalid throughput"); }
+            profile.throughput.push_back({.items = *items, .bytes = *bytes});
+        }
+    }
+
+    // A fit from a JSON report, in the time unit of its samples
+    void set_complexity(ComplexityAnalysis&& analysis) { complexity = std::move(analysis); }
+
+    [[nodiscard]] RuntimeProfile<Unit> finish()
+    {
+        const size_t samples = profile.size();
+        if ((!profile.counters.empty() && profile.counters.size() != samples) ||
+            (!profile.allocations.empty() && profile.allocations.size() != samples) ||
+            (!profile.cpu_ids.empty() && profile.cpu_ids.size() != samples) ||
+            (!profile.cache_modes.empty() && profile.cache_modes.size() != samples) ||
+            (!profile.process_usage.empty() && profile.process_usage.size() != samples) ||
+            (!profile.throughput.empty() && profile.throughput.size() != samples))
+        {
+            throw report_error(filename, "optional columns are missing from some samples");
+        }
+
+        if (complexity && samples > 0)
+        {
+            complexity->rescale(unit_factor<Unit>(time_unit).value_or(1.0));
+            attach_complexity(profile, std::move(*complexity));
+        }
+        return std::move(profile);
+    }
+
+private:
+    std::filesystem::path filename;
+    RuntimeProfile<Unit> profile;
+    std::string_view time_unit; // Of the first row, views the report text
+    std::optional<ComplexityAnalysis> complexity;
+};
+
+// Pops the text up to `separator`, or all of it
+[[nodiscard]] inline std::string_view next_token(std::string_view& text, char separator) noexcept
+{
+    const auto end = text.find(separator);
+    const auto token = text.substr(0, end);
+    text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+    return token;
+}
+
+// Single pass over the rows: the header maps each column to a field once, then every line is split in place
+template <ChronoDuration Unit>
+[[nodiscard]] RuntimeProfile<Unit> read_csv_profile(std::string_view text, const std::filesystem::path& filename)
+{
+    auto next_line = [&text]() {
+        auto line = next_token(text, '\n');
+        if (line.ends_with('\r')) { line.remove_suffix(1); }
+        return line;
+    };
+
+    std::vector<FieldId> fields;
+    for (auto header = next_line(); !header.empty();) { fields.push_back(field_id(next_token(header, ','))); }
+    if (std::ranges::find(fields, ReportField::sample_size, &FieldId::kind) == fields.end() ||
+        std::ranges::find(fields, ReportField::time_value, &FieldId::kind) == fields.end())
+    {
+        throw report_error(filename, "missing time_value or sample_size column");
+    }
+
+    ProfileBuilder<Unit> builder(filename);
+    while (!text.empty())
+    {
+        auto line = next_line();
+        if (line.empty()) { continue; }
+
+        ReportRow row;
+        for (const auto& field : fields) { row.set(field, next_token(line, ',')); }
+        builder.add(row);
+    }
+    return builder.finish();
+}
+
+// Reader for the JSON written by the reporters: objects, arrays, strings without escapes, numbers and null
+class JsonCursor
+{
+public:
+    JsonCursor(std::string_view text, const std::filesystem::path& filename) : text(text), filename(filename) {}
+
+    [[nodiscard]] char peek() noexcept
+    {
+        const auto start = text.find_first_not_of(" \t\r\n");
+        text.remove_prefix(start == std::string_view::npos ? text.size() : start);
+        return text.empty() ? '\0' : text.front();
+    }
+
+    [[nodiscard]] bool accept(char expected) noexcept
+    {
+        if (peek() != expected) return false;
+        text.remove_prefix(1);
+        return true;
+    }
+
+    void expect(char expected)
+    {
+        if (!accept(expected)) { throw error(std::string("expected '") + expected + "'"); }
+    }
+
+    [[nodiscard]] std::string_view string()
+    {
+        expect('"');
+        const auto end = text.find('"');
+        if (end == std::string_view::npos) { throw error("unterminated string"); }
+        const auto value = text.substr(0, end);
+        text.remove_prefix(end + 1);
+        return value;
+    }
+
+    // A string's contents, or the literal text of a number or null
+    [[nodiscard]] std::string_view scalar()
+    {
+        if (peek() == '"') return string();
+        const auto end = std::min(text.find_first_of(",}] \t\r\n"), text.size());
+        if (end == 0) { throw error("expected a value"); }
+        const auto value = text.substr(0, end);
+        text.remove_prefix(end);
+        return value;
+    }
+
+    void skip_value()
+    {
+        if (accept('{'))
+        {
+            if (accept('}')) return;
+            do
+            {
+                (void)string();
+                expect(':');
+                skip_value();
+            } while (accept(','));
+            expect('}');
+        }
+        else if (accept('['))
+        {
+            if (accept(']')) return;
+            do { skip_value(); } while (accept(','));
+            expect(']');
+        }
+        else { (void)scalar(); }
+    }
+
+    // Calls on_member(key) for each member of an object, which must consume the value
+    template <typename F>
+    void object(F&& on_member)
+    {
+        expect('{');
+        if (accept('}')) return;
+        do
+        {
+            const auto key = string();
+            expect(':');
+            on_member(key);
+        } while (accept(','));
+        expect('}');
+    }
+
+    template <typename F>
+    void array(F&& on_element)
+    {
+        expect('[');
+        if (accept(']')) return;
+        do { on_element(); } while (accept(','));
+        expect(']');
+    }
+
+    [[nodiscard]] std::runtime_error error(const std::string& reason) const
+    {
+        return report_error(filename, reason + " before \"" + std::string(text.substr(0, 20)) + "\"");
+    }
+
+private:
+    std::string_view text;
+    const std::filesystem::path& filename;
+};
+
+inline ReportRow read_json_sample(JsonCursor& cursor)
+{
+    ReportRow row;
+    cursor.object([&](std::string_view key) {
+        const auto field = field_id(key);
+        if (field.kind == ReportField::ignored) { cursor.skip_value(); }
+        else { row.set(field, cursor.scalar()); }
+    });
+    return row;
+}
+
+inline ComplexityAnalysis read_json_complexity(JsonCursor& cursor)
+{
+    ComplexityAnalysis analysis;
+    std::string_view best;
+
+    auto number = [&cursor](std::string_view text) {
+        const auto value = parse_number<double>(text);
+        if (!value && text != "null") { throw cursor.error("invalid number in complexity fit"); }
+        return value.value_or(0.0);
+    };
+
+    cursor.object([&](std::string_view key) {
+        if (key == "best_fit") { best = cursor.string(); }
+        else if (key != "fits") { cursor.skip_value(); }
+        else
+        {
+            cursor.array([&] {
+                ComplexityFit fit;
+                cursor.object([&](std::string_view member) {
+                    if (member == "class")
+                    {
+                        const auto complexity = parse_complexity_class(cursor.string());
+                        if (!complexity) { throw cursor.error("unknown complexity class"); }
+                        fit.complexity = *complexity;
+                    }
+                    else if (member == "intercept") { fit.intercept = number(cursor.scalar()); }
+                    else if (member == "coefficient") { fit.coefficient = number(cursor.scalar()); }
+                    else if (member == "exponent") { fit.exponent = number(cursor.scalar()); }
+                    else if (member == "r_squared") { fit.r_squared = number(cursor.scalar()); }
+                    else { cursor.skip_value(); }
+                });
+                analysis.fits.push_back(std::move(fit));
+            });
+        }
+    });
+
+    for (size_t i = 0; i < analysis.fits.size(); ++i)
+    {
+        if (to_string(analysis.fits[i].complexity) == best) { analysis.best = i; }
+    }
+    return analysis;
+}
+
+// A JSON report is {"samples": [...], "complexity": {...}}, or a plain array of samples from reports written before
+// the object form. JSON lines hold one sample per line
+template <ChronoDuration Unit>
+[[nodiscard]] RuntimeProfile<Unit> read_json_profile(std::string_view text,
+                                                     const std::filesystem::path& filename,
+                                                     bool json_lines)
+{
+    ProfileBuilder<Unit> builder(filename);
+
+    if (json_lines)
+    {
+        while (!text.empty())
+        {
+            JsonCursor cursor(next_token(text, '\n'), filename);
+            if (cursor.peek() == '\0') { continue; }
+            builder.add(read_json_sample(cursor));
+        }
+        return builder.finish();
+    }
+
+    JsonCursor cursor(text, filename);
+    auto samples = [&] { cursor.array([&] { builder.add(read_json_sample(cursor)); }); };
+    if (cursor.peek() == '[') { samples(); }
+    else
+    {
+        cursor.object([&](std::string_view key) {
+            if (key == "samples") { samples(); }
+            else if (key == "complexity") { builder.set_complexity(read_json_complexity(cursor)); }
+            else { cursor.skip_value(); }
+        });
+    }
+    if (cursor.peek() != '\0') { throw cursor.error("unexpected text after the report"); }
+    return builder.finish();
+}
+
+} // namespace detail
+
+// Reads a report written by save_report or a ReportSink back into a profile, choosing the format by extension:
+// .csv, .json, .jsonl or .srp. Times are converted to Unit. Text reports keep only the median of each sample, so it
+// becomes the single repetition; binary profiles keep every repetition
+template <ChronoDuration Unit>
+[[nodiscard]] RuntimeProfile<Unit> load_profile(const std::filesystem::path& filename)
+{
+    const auto ext = filename.extension();
+    if (ext == ".srp") { return load_binary_profile<Unit>(filename); }
+    if (ext != ".csv" && ext != ".json" && ext != ".jsonl")
+    {
+        throw std::runtime_error("Error: Unsupported file extension " + ext.string());
+    }
+
+    // The file is mapped and parsed in place, the profile never views it after loading
+    const detail::MappedFile file(filename);
+    const std::string_view text(reinterpret_cast<const char*>(file.bytes().data()), file.bytes().size());
+
+    if (ext == ".csv") { return detail::read_csv_profile<Unit>(text, filename); }
+    return detail::read_json_profile<Unit>(text, filename, ext == ".jsonl");
+}
+
+// Combines profiles of the same benchmark, e.g. from several machines or nights. Samples are aligned by sample size:
+// the repetitions of equal sizes are pooled and the median recomputed, counters and allocation statistics are
+// averaged weighted by repetitions. When any input stores its samples as histograms, the histograms are merged and
+// the repetitions of the other inputs recorded into them. The result is sorted by size and refitted if any input had
+// a complexity fit
+template <ChronoDuration Unit>
+[[nodiscard]] RuntimeProfile<Unit> merge_profiles(std::span<const RuntimeProfile<Unit>* const> profiles)
+{
+    struct PooledSample
+    {
+        std::vector<Unit> repetitions;
+        std::optional<LatencyHistogram> histogram;
+        std::array<double, detail::counter_fields.size()> counter_sums{};
+        std::array<double, detail::counter_fields.size()> counter_weights{};
+        AllocationStats allocations{};
+        double allocation_weight = 0.0;
+        std::optional<int> cpu_id;
+        bool mixed_cpus = false;
+        std::optional<CacheMode> cache_mode;
+        bool mixed_cache_modes = false;
+        ProcessUsage usage{};
+        std::optional<Throughput> throughput;
+        bool mixed_throughput = false;
+    };
+
+    std::map<size_t, PooledSample> pooled;
+    bool has_counters = !profiles.empty(), has_allocations = !profiles.empty(), has_cpus = !profiles.empty();
+    bool has_cache_modes = !profiles.empty(), has_usage = !profiles.empty(), has_throughput = !profiles.empty();
+    bool refit = false;
+    std::optional<unsigned> histogram_precision;
+    // Fractions of peak are only comparable when every input was measured against the same peak
+    std::optional<double> peak_bandwidth = profiles.empty() ? std::nullopt : profiles.front()->peak_bandwidth;
+
+    for (const auto* input : profiles)
+    {
+        if (!input->histograms.empty() && !histogram_precision)
+        {
+            histogram_precision = input->histograms.front().precision_bits();
+        }
+    }
+
+    for (const auto* input : profiles)
+    {
+        const auto& profile = *input;
+        has_counters = has_counters && !profile.counters.empty();
+        has_allocations = has_allocations && !profile.allocations.empty();
+        has_cpus = has_cpus && !profile.cpu_ids.empty();
+        has_cache_modes = has_cache_modes && !profile.cache_modes.empty();
+        has_usage = has_usage && !profile.process_usage.empty();
+        has_throughput = has_throughput && !profile.throughput.empty();
+        refit = refit || profile.complexity.has_value();
+        if (profile.peak_bandwidth != peak_bandwidth) { peak_bandwidth.reset(); }
+
+        for (size_t i = 0; i < profile.size(); ++i)
+        {
+            auto& sample = pooled[profile.sample_sizes[i]];
+            const auto& runs = profile.repetitions[i];
+            sample.repetitions.insert(sample.repetitions.end(), runs.begin(), runs.end());
+
+            size_t run_count = runs.size();
+            if (runs.empty() && i < profile.histograms.size())
+            {
+                const auto& histogram = profile.histograms[i];
+                if (sample.histogram) { sample.histogram->merge(histogram); }
+                else { sample.histogram.emplace(histogram); }
+                run_count = static_cast<size_t>(histogram.count());
+            }
+
+            // Counters and allocations are averages per run, so each sample weighs as much as its repetitions
+            const double weight = static_cast<double>(std::max<size_t>(run_count, 1));
+            if (!profile.counters.empty())
+            {
+                for (size_t c = 0; c < detail::counter_fields.size(); ++c)
+                {
+                    if (const auto value = profile.counters[i].*detail::counter_fields[c].member)
+                    {
+                        sample.counter_sums[c] += *value * weight;
+                        sample.counter_weights[c] += weight;
+                    }
+                }
+            }
+            if (!profile.allocations.empty())
+            {
+                const auto& stats = profile.allocations[i];
+                sample.allocations.allocations += stats.allocations * weight;
+                sample.allocations.bytes_allocated += stats.bytes_allocated * weight;
+                auto& peak = sample.allocations.peak_live_bytes;
+                peak = std::max(peak, stats.peak_live_bytes);
+                sample.allocation_weight += weight;
+            }
+            if (!profile.cpu_ids.empty())
+            {
+                if (sample.cpu_id && *sample.cpu_id != profile.cpu_ids[i]) { sample.mixed_cpus = true; }
+                sample.cpu_id = profile.cpu_ids[i];
+            }
+            if (!profile.process_usage.empty())
+            {
+                const auto& usage = profile.process_usage[i];
+                sample.usage.max_rss_bytes = std::max(sample.usage.max_rss_bytes, usage.max_rss_bytes);
+                sample.usage.voluntary_switches += usage.voluntary_switches;
+                sample.usage.involuntary_switches += usage.involuntary_switches;
+            }
+            if (!profile.cache_modes.empty())
+            {
+                const auto mode = profile.cache_modes[i];
+                if (sample.cache_mode && *sample.cache_mode != mode) { sample.mixed_cache_modes = true; }
+                sample.cache_mode = mode;
+            }
+            if (!profile.throughput.empty())
+            {
+                const auto& throughput = profile.throughput[i];
+                if (sample.throughput && (sample.throughput->items != throughput.items ||
+                                          sample.throughput->bytes != throughput.bytes))
+                {
+                    sample.mixed_throughput = true;
+                }
+                sample.throughput = throughput;
+            }
+        }
+    }
+
+    // A size measured on several cores has no single CPU id, so the column is dropped. Same for a size measured in
+    // several cache states, pooling them would hide which regime the numbers are from, and for inputs that counted
+    // the work of a size differently, which measured different things
+    for (const auto& [size, sample] : pooled)
+    {
+        has_cpus = has_cpus && !sample.mixed_cpus;
+        has_cache_modes = has_cache_modes && !sample.mixed_cache_modes;
+        has_throughput = has_throughput && !sample.mixed_throughput;
+    }
+
+    RuntimeProfile<Unit> merged;
+    merged.reserve(pooled.size());
+    for (auto& [size, sample] : pooled)
+    {
+        SampleMeasurement<Unit> measurement;
+        measurement.sample_size = size;
+        if (histogram_precision)
+        {
+            if (!sample.histogram) { sample.histogram.emplace(*histogram_precision); }
+            for (const auto& run : sample.repetitions)
+            {
+                const std::chrono::duration<double, std::nano> nanoseconds(run);
+                sample.histogram->record(static_cast<std::uint64_t>(std::llround(std::max(nanoseconds.count(), 0.0))));
+            }
+            measurement.histogram = std::move(sample.histogram);
+        }
+        else { measurement.repetitions = std::move(sample.repetitions); }
+        if (has_counters)
+        {
+            auto& counters = measurement.counters.emplace();
+            for (size_t c = 0; c < detail::counter_fields.size(); ++c)
+            {
+                if (sample.counter_weights[c] > 0.0)
+                {
+                    counters.*detail::counter_fields[c].member = sample.counter_sums[c] / sample.counter_weights[c];
+                }
+            }
+        }
+        if (has_allocations)
+        {
+            auto& stats = measurement.allocations.emplace(sample.allocations);
+            stats.allocations /= sample.allocation_weight;
+            stats.bytes_allocated /= sample.allocation_weight;
+        }
+        if (has_cpus) { measurement.cpu_id = sample.cpu_id; }
+        if (has_cache_modes) { measurement.cache_mode = sample.cache_mode; }
+        if (has_usage) { measurement.process_usage = sample.usage; }
+        if (has_throughput) { measurement.throughput = sample.throughput; }
+        merged.append(std::move(measurement));
+    }
+    merged.peak_bandwidth = peak_bandwidth;
+
+    if (refit && merged.size() >= 2 && merged.sample_sizes.front() >= 1)
+    {
+        std::vector<double> sizes, times;
+        sizes.reserve(merged.size());
+        times.reserve(merged.size());
+        for (size_t i = 0; i < merged.size(); ++i)
+        {
+            sizes.push_back(static_cast<double>(merged.sample_sizes[i]));
+            times.push_back(static_cast<double>(merged.raw_durations[i].count()));
+        }
+        merged.complexity = fit_complexity(sizes, times);
+    }
+
+    return merged;
+}
+
+template <ChronoDuration Unit>
+[[nodiscard]] RuntimeProfile<Unit> merge_profiles(std::span<const RuntimeProfile<Unit>> profiles)
+{
+    std::vector<const RuntimeProfile<Unit>*> inputs;
+    inputs.reserve(profiles.size());
+    for (const auto& profile : profiles) { inputs.push_back(&profile); }
+    return merge_profiles<Unit>(std::span<const RuntimeProfile<Unit>* const>(inputs));
+}
+
+template <ChronoDuration Unit>
+[[nodiscard]] RuntimeProfile<Unit> merge_profiles(const RuntimeProfile<Unit>& first, const RuntimeProfile<Unit>& second)
+{
+    const std::array<const RuntimeProfile<Unit>*, 2> inputs = {&first, &second};
+    return merge_profiles<Unit>(std::span<const RuntimeProfile<Unit>* const>(inputs));
+}
+
+} // namespace sra
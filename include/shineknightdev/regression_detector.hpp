@@ -0,0 +1,479 @@
+/**
+ * @file regression_detector.hpp
+ * * @brief Statistical comparison of a candidate profile against a baseline
+ *
+ * @project Simple Runtime Analyzer
+ *
+ * @author Diego Osorio (ShineKnightDev)
+ *
+ * @copyright Copyright (c) 2025 Diego Osorio (ShineKnightDev)
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <limits>
+#include <map>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "shineknightdev/latency_histogram.hpp"
+#include "shineknightdev/runtime_analyzer.hpp"
+#include "shineknightdev/sample_utilities.hpp"
+
+namespace sra
+{
+
+enum class RegressionTest
+{
+    mann_whitney, // Rank test on the repetitions, exact for small samples without ties
+    bootstrap     // Percentile interval of the median ratio over resampled repetitions
+};
+
+enum class PerformanceChange
+{
+    unchanged,
+    improved,
+    regressed
+};
+
+[[nodiscard]] constexpr std::string_view to_string(RegressionTest test) noexcept
+{
+    return test == RegressionTest::mann_whitney ? "mann_whitney" : "bootstrap";
+}
+
+[[nodiscard]] constexpr std::string_view to_string(PerformanceChange change) noexcept
+{
+    switch (change)
+    {
+        case PerformanceChange::unchanged: return "unchanged";
+        case PerformanceChange::improved: return "improved";
+        case PerformanceChange::regressed: return "regressed";
+    }
+    return "unknown";
+}
+
+struct RegressionConfig
+{
+    RegressionTest test = RegressionTest::mann_whitney;
+    double threshold = 0.05; // Relative change of the median that matters, smaller significant changes are ignored
+    double alpha = 0.05;     // Significance level of the test at each size
+    size_t bootstrap_resamples = 10000;
+    std::uint64_t seed = 0x5EED; // Of the bootstrap resampling, so a comparison is reproducible
+    size_t histogram_runs = 10000; // Most repetitions taken from a sample stored as a histogram
+};
+
+// Comparison at one sample size. Sizes where either side has fewer than two repetitions cannot be tested and are
+// judged by the threshold alone
+template <ChronoDuration Unit>
+struct SizeComparison
+{
+    size_t sample_size = 0;
+    size_t baseline_runs = 0;
+    size_t candidate_runs = 0;
+    Fractional<Unit> baseline_median{};
+    Fractional<Unit> candidate_median{};
+    double ratio = 1.0;                                      // Candidate over baseline median, above 1 is slower
+    std::optional<double> p_value;                           // Two-sided, nullopt when the size was not tested
+    std::optional<std::pair<double, double>> ratio_interval; // 1 - alpha interval of the ratio, bootstrap only
+    PerformanceChange change = PerformanceChange::unchanged;
+};
+
+template <ChronoDuration Unit>
+struct RegressionReport
+{
+    std::vector<SizeComparison<Unit>> sizes; // Sizes present in both profiles, in increasing order
+    size_t unmatched_sizes = 0;              // Sizes present in only one of the profiles
+    PerformanceChange verdict = PerformanceChange::unchanged; // Regressed if any size regressed
+    RegressionConfig config;
+    std::string unit_symbol;
+
+    RegressionReport() : unit_symbol(get_unit_symbol<Unit>()) {}
+
+    [[nodiscard]] size_t count(PerformanceChange change) const noexcept
+    {
+        return static_cast<size_t>(std::ranges::count(sizes, change, &SizeComparison<Unit>::change));
+    }
+
+    // For CI jobs: 1 when the candidate regressed, 0 otherwise
+    [[nodiscard]] int exit_code() const noexcept { return verdict == PerformanceChange::regressed ? 1 : 0; }
+};
+
+namespace detail
+{
+
+inline void validate_regression_config(const RegressionConfig& config)
+{
+    if (!(config.threshold >= 0.0) || !(config.alpha > 0.0 && config.alpha < 1.0) || config.bootstrap_resamples == 0 ||
+        config.histogram_runs == 0)
+    {
+        throw std::invalid_argument(
+            "Regression check requires a threshold >= 0, 0 < alpha < 1, resamples and histogram runs");
+    }
+}
+
+[[nodiscard]] inline double median_value(std::vector<double> values)
+{
+    const size_t middle = values.size() / 2;
+    std::ranges::nth_element(values, values.begin() + static_cast<std::ptrdiff_t>(middle));
+    const double upper = values[middle];
+    if (values.size() % 2 == 1) return upper;
+    return (*std::max_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(middle)) + upper) / 2.0;
+}
+
+[[nodiscard]] inline double median_ratio(double baseline, double candidate) noexcept
+{
+    if (baseline > 0.0) return candidate / baseline;
+    return candidate > 0.0 ? std::numeric_limits<double>::infinity() : 1.0;
+}
+
+// Number of orderings of m baseline and n candidate runs for each value of U, the count of (baseline, candidate)
+// pairs where the baseline run is larger
+[[nodiscard]] inline std::vector<double> mann_whitney_distribution(size_t m, size_t n)
+{
+    const size_t max_u = m * n;
+    // ways[j][u] after placing i baseline runs: orderings with j candidate runs placed and statistic u
+    std::vector<std::vector<double>> ways(n + 1, std::vector<double>(max_u + 1, 0.0));
+    for (size_t i = 0; i <= m; ++i)
+    {
+        for (size_t j = 0; j <= n; ++j)
+        {
+            if (i == 0 && j == 0)
+            {
+                ways[0][0] = 1.0;
+                continue;
+            }
+            // Placing a baseline run last adds j pairs, placing a candidate run last adds none
+            std::vector<double> next(max_u + 1, 0.0);
+            for (size_t u = 0; u <= max_u; ++u)
+            {
+                if (i > 0 && u >= j) { next[u] += ways[j][u - j]; }
+                if (j > 0) { next[u] += ways[j - 1][u]; }
+            }
+            ways[j] = std::move(next);
+        }
+    }
+    return ways[n];
+}
+
+// Two-sided p-value of the Mann-Whitney U test. Exact for up to 40 runs without ties, otherwise the normal
+// approximation with tie and continuity corrections
+[[nodiscard]] inline double mann_whitney_p_value(std::span<const double> baseline, std::span<const double> candidate)
+{
+    const size_t m = baseline.size(), n = candidate.size(), total = m + n;
+
+    std::vector<std::pair<double, bool>> runs; // Value, whether it belongs to the baseline
+    runs.reserve(total);
+    for (double value : baseline) { runs.emplace_back(value, true); }
+    for (double value : candidate) { runs.emplace_back(value, false); }
+    std::ranges::sort(runs, {}, &std::pair<double, bool>::first);
+
+    double baseline_ranks = 0.0, tie_sum = 0.0;
+    for (size_t i = 0; i < total;)
+    {
+        size_t end = i;
+        while (end < total && runs[end].first == runs[i].first) { ++end; }
+        const double tied = static_cast<double>(end - i);
+        const double rank = (static_cast<double>(i + 1) + static_cast<double>(end)) / 2.0;
+        for (size_t k = i; k < end; ++k)
+        {
+            if (runs[k].second) { baseline_ranks += rank; }
+        }
+        tie_sum += tied * tied * tied - tied;
+        i = end;
+    }
+
+    const double md = static_cast<double>(m), nd = static_cast<double>(n);
+    const double u = baseline_ranks - md * (md + 1.0) / 2.0;
+
+    if (tie_sum == 0.0 && total <= 40)
+    {
+        const auto ways = mann_whitney_distribution(m, n);
+        double below = 0.0, above = 0.0, all = 0.0;
+        const auto statistic = static_cast<size_t>(u);
+        for (size_t k = 0; k < ways.size(); ++k)
+        {
+            all += ways[k];
+            if (k <= statistic) { below += ways[k]; }
+            if (k >= statistic) { above += ways[k]; }
+        }
+        return std::min(1.0, 2.0 * std::min(below, above) / all);
+    }
+
+    const double mean = md * nd / 2.0;
+    const double variance =
+        md * nd / 12.0 * ((static_cast<double>(total) + 1.0) - tie_sum / (static_cast<double>(total) * (total - 1.0)));
+    if (variance <= 0.0) return 1.0;
+    const double z = std::max(std::abs(u - mean) - 0.5, 0.0) / std::sqrt(variance);
+    return std::erfc(z / std::sqrt(2.0));
+}
+
+struct BootstrapResult
+{
+    double p_value = 1.0;
+    std::pair<double, double> interval{1.0, 1.0};
+};
+
+// Resamples both sides with replacement and collects the ratio of their medians. Indices come from the Philox
+// generator of SampleFiller, so the result depends only on the seed and the data
+[[nodiscard]] inline BootstrapResult bootstrap_ratio(std::span<const double> baseline,
+                                                     std::span<const double> candidate,
+                                                     const RegressionConfig& config,
+                                                     std::uint64_t stream)
+{
+    std::vector<double> ratios;
+    ratios.reserve(config.bootstrap_resamples);
+    std::vector<double> resample;
+
+    auto resampled_median = [&resample](std::span<const double> values, std::uint64_t seed, std::uint64_t index) {
+        resample.clear();
+        for (size_t i = 0; i < values.size(); i += 4)
+        {
+            const auto bits = element_bits(seed, index, i / 4);
+            for (size_t k = 0; k < 4 && i + k < values.size(); ++k)
+            {
+                resample.push_back(values[(std::uint64_t{bits[k]} * values.size()) >> 32]);
+            }
+        }
+        return median_value(resample);
+    };
+
+    for (size_t r = 0; r < config.bootstrap_resamples; ++r)
+    {
+        const double base = resampled_median(baseline, config.seed ^ stream, 2 * r);
+        const double cand = resampled_median(candidate, config.seed ^ stream, 2 * r + 1);
+        ratios.push_back(median_ratio(base, cand));
+    }
+    std::ranges::sort(ratios);
+
+    const auto below = static_cast<double>(std::ranges::upper_bound(ratios, 1.0) - ratios.begin());
+    const auto above = static_cast<double>(ratios.end() - std::ranges::lower_bound(ratios, 1.0));
+    const double resamples = static_cast<double>(ratios.size());
+
+    BootstrapResult result;
+    result.p_value = std::min(1.0, 2.0 * std::min(below, above) / resamples);
+    result.interval = {percentile_sorted(ratios, config.alpha / 2.0),
+                       percentile_sorted(ratios, 1.0 - config.alpha / 2.0)};
+    return result;
+}
+
+// Repetitions recorded in a histogram, each at the midpoint of its bucket and scaled from nanoseconds. A histogram of
+// more than `limit` repetitions gives `limit` of them at evenly spaced ranks, which keeps the shape of the distribution
+inline void append_histogram_runs(std::vector<double>& values,
+                                  const LatencyHistogram& histogram,
+                                  size_t limit,
+                                  double scale)
+{
+    const std::uint64_t recorded = histogram.count();
+    const std::uint64_t taken = std::min<std::uint64_t>(recorded, limit);
+    const double step = taken == 0 ? 0.0 : static_cast<double>(recorded) / static_cast<double>(taken);
+    std::uint64_t seen = 0;
+    std::uint64_t next = 0;
+    for (size_t bucket = 0; bucket < histogram.bucket_count() && next < taken; ++bucket)
+    {
+        const auto count = histogram.count_at(bucket);
+        if (count == 0) { continue; }
+        seen += count;
+        const double value = histogram.midpoint(bucket) * scale;
+        while (next < taken && (static_cast<double>(next) + 0.5) * step < static_cast<double>(seen))
+        {
+            values.push_back(value);
+            ++next;
+        }
+    }
+}
+
+// Repetitions of every sample of each size, in the unit of the profile. Samples stored as histograms are expanded
+// from their buckets, so they are tested like any other sample
+template <ChronoDuration Unit>
+[[nodiscard]] std::map<size_t, std::vector<double>> runs_by_size(const RuntimeProfile<Unit>& profile,
+                                                                 size_t histogram_runs)
+{
+    const double unit_per_ns =
+        std::chrono::duration_cast<Fractional<Unit>>(std::chrono::duration<double, std::nano>(1.0)).count();
+
+    std::map<size_t, std::vector<double>> runs;
+    for (size_t i = 0; i < profile.size(); ++i)
+    {
+        auto& values = runs[profile.sample_sizes[i]];
+        if (!profile.repetitions[i].empty())
+        {
+            for (const auto& run : profile.repetitions[i]) { values.push_back(static_cast<double>(run.count())); }
+        }
+        else if (i < profile.histograms.size() && !profile.histograms[i].empty())
+        {
+            append_histogram_runs(values, profile.histograms[i], histogram_runs, unit_per_ns);
+        }
+        else { values.push_back(static_cast<double>(profile.raw_durations[i].count())); }
+    }
+    return runs;
+}
+
+} // namespace detail
+
+// Tests every sample size measured in both profiles for a change of the candidate against the baseline. A size is
+// regressed or improved when its median changed by more than the threshold and the test is significant at alpha
+template <ChronoDuration Unit>
+[[nodiscard]] RegressionReport<Unit> compare_profiles(const RuntimeProfile<Unit>& baseline,
+                                                      const RuntimeProfile<Unit>& candidate,
+                                                      const RegressionConfig& config = {})
+{
+    detail::validate_regression_config(config);
+
+    const auto baseline_runs = detail::runs_by_size(baseline, config.histogram_runs);
+    const auto candidate_runs = detail::runs_by_size(candidate, config.histogram_runs);
+
+    RegressionReport<Unit> report;
+    report.config = config;
+
+    for (const auto& [size, runs] : baseline_runs)
+    {
+        if (!candidate_runs.contains(size)) { ++report.unmatched_sizes; }
+    }
+
+    for (const auto& [size, candidate_values] : candidate_runs)
+    {
+        const auto match = baseline_runs.find(size);
+        if (match == baseline_runs.end())
+        {
+            ++report.unmatched_sizes;
+            continue;
+        }
+        const auto& baseline_values = match->second;
+        if (baseline_values.empty() || candidate_values.empty()) { continue; }
+
+        SizeComparison<Unit> comparison;
+        comparison.sample_size = size;
+        comparison.baseline_runs = baseline_values.size();
+        comparison.candidate_runs = candidate_values.size();
+        comparison.baseline_median = Fractional<Unit>(detail::median_value(baseline_values));
+        comparison.candidate_median = Fractional<Unit>(detail::median_value(candidate_values));
+        comparison.ratio =
+            detail::median_ratio(comparison.baseline_median.count(), comparison.candidate_median.count());
+
+        bool significant = true;
+        if (baseline_values.size() >= 2 && candidate_values.size() >= 2)
+        {
+            if (config.test == RegressionTest::mann_whitney)
+            {
+                comparison.p_value = detail::mann_whitney_p_value(baseline_values, candidate_values);
+            }
+            else
+            {
+                const auto result = detail::bootstrap_ratio(baseline_values, candidate_values, config, size);
+                comparison.p_value = result.p_value;
+                comparison.ratio_interval = result.interval;
+            }
+            significant = *comparison.p_value < config.alpha;
+        }
+
+        if (significant && comparison.ratio > 1.0 + config.threshold)
+        {
+            comparison.change = PerformanceChange::regressed;
+        }
+        else if (significant && comparison.ratio < 1.0 - config.threshold)
+        {
+            comparison.change = PerformanceChange::improved;
+        }
+        report.sizes.push_back(std::move(comparison));
+    }
+
+    if (report.count(PerformanceChange::regressed) > 0) { report.verdict = PerformanceChange::regressed; }
+    else if (report.count(PerformanceChange::improved) > 0) { report.verdict = PerformanceChange::improved; }
+    return report;
+}
+
+namespace detail
+{
+
+// Report writers, found by print_report, save_report and generate_report like those of the profiles
+
+template <ChronoDuration Unit>
+void write_text_report_impl(std::ostream& out, const RegressionReport<Unit>& report)
+{
+    out << std::format("Regression check: {} | {} regressed, {} improved of {} sizes | test: {} | threshold: {:.2f}% "
+                       "| alpha: {}\n",
+                       to_string(report.verdict), report.count(PerformanceChange::regressed),
+                       report.count(PerformanceChange::improved), report.sizes.size(), to_string(report.config.test),
+                       report.config.threshold * 100.0, report.config.alpha);
+    if (report.unmatched_sizes > 0) { out << "Sizes in only one profile: " << report.unmatched_sizes << "\n"; }
+
+    for (const auto& size : report.sizes)
+    {
+        out << std::format("Size {}: | Baseline: {:.6g} {} | Candidate: {:.6g} {} | Ratio: {:.4f}", size.sample_size,
+                           size.baseline_median.count(), report.unit_symbol, size.candidate_median.count(),
+                           report.unit_symbol, size.ratio);
+        if (size.ratio_interval)
+        {
+            out << std::format(" [{:.4f}, {:.4f}]", size.ratio_interval->first, size.ratio_interval->second);
+        }
+        if (size.p_value) { out << std::format(" | p: {:.4g}", *size.p_value); }
+        else { out << " | p: untested"; }
+        out << " | " << to_string(size.change) << "\n";
+    }
+}
+
+template <ChronoDuration Unit>
+void write_csv_report_impl(std::ostream& out, const RegressionReport<Unit>& report)
+{
+    out << "sample_size,time_unit,baseline_runs,candidate_runs,baseline_median,candidate_median,ratio,ratio_low,"
+           "ratio_high,p_value,change\n";
+    for (const auto& size : report.sizes)
+    {
+        out << std::format("{},{},{},{},{},{},{},", size.sample_size, report.unit_symbol, size.baseline_runs,
+                           size.candidate_runs, size.baseline_median.count(), size.candidate_median.count(),
+                           size.ratio);
+        if (size.ratio_interval) { out << size.ratio_interval->first << "," << size.ratio_interval->second; }
+        else { out << ","; }
+        out << "," << (size.p_value ? std::format("{}", *size.p_value) : "") << "," << to_string(size.change) << "\n";
+    }
+}
+
+template <ChronoDuration Unit>
+void write_json_report_impl(std::ostream& out, const RegressionReport<Unit>& report)
+{
+    // JSON has no infinity, a ratio over a zero baseline is written as null
+    auto optional_number = [](const std::optional<double>& value) {
+        return value && std::isfinite(*value) ? std::format("{}", *value) : std::string("null");
+    };
+
+    out << "{\n"
+        << "  \"verdict\": \"" << to_string(report.verdict) << "\",\n"
+        << "  \"test\": \"" << to_string(report.config.test) << "\",\n"
+        << std::format("  \"threshold\": {},\n  \"alpha\": {},\n", report.config.threshold, report.config.alpha)
+        << "  \"time_unit\": \"" << report.unit_symbol << "\",\n"
+        << "  \"unmatched_sizes\": " << report.unmatched_sizes << ",\n"
+        << "  \"sizes\": [";
+    for (size_t i = 0; i < report.sizes.size(); ++i)
+    {
+        const auto& size = report.sizes[i];
+        out << (i > 0 ? ",\n" : "\n")
+            << std::format("    {{\"sample_size\": {}, \"baseline_runs\": {}, \"candidate_runs\": {}, "
+                           "\"baseline_median\": {}, \"candidate_median\": {}, ",
+                           size.sample_size, size.baseline_runs, size.candidate_runs, size.baseline_median.count(),
+                           size.candidate_median.count())
+            << "\"ratio\": " << optional_number(size.ratio) << ", \"ratio_low\": "
+            << optional_number(size.ratio_interval ? std::optional(size.ratio_interval->first) : std::nullopt)
+            << ", \"ratio_high\": "
+            << optional_number(size.ratio_interval ? std::optional(size.ratio_interval->second) : std::nullopt)
+            << ", \"p_value\": " << optional_number(size.p_value) << ", \"change\": \"" << to_string(size.change)
+            << "\"}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+} // namespace detail
+
+} // namespace sra
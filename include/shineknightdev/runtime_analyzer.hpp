@@ -12,11 +12,21 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cmath>
 #include <concepts>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <ratio>
 #include <ranges>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <string_view>
@@ -24,6 +34,24 @@
 #include <utility>
 #include <vector>
 
+#include "shineknightdev/allocation_tracker.hpp"
+#include "shineknightdev/cache_control.hpp"
+#include "shineknightdev/complexity_analyzer.hpp"
+#include "shineknightdev/hardware_counters.hpp"
+#include "shineknightdev/latency_histogram.hpp"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#    define SRA_HAS_TSC 1
+#    if defined(_MSC_VER)
+#        include <intrin.h>
+#    else
+#        include <cpuid.h>
+#        include <x86intrin.h>
+#    endif
+#else
+#    define SRA_HAS_TSC 0
+#endif
+
 namespace sra
 {
 
@@ -31,54 +59,477 @@ namespace sra
 template <typename T>
 concept ChronoDuration = requires
 {
-    requires std::is_same_v<T, std::chrono::nanoseconds> || 
-             std::is_same_v<T, std::chrono::microseconds> ||
-             std::is_same_v<T, std::chrono::milliseconds> || 
-             std::is_same_v<T, std::chrono::seconds> ||
-             std::is_same_v<T, std::chrono::minutes> || 
-             std::is_same_v<T, std::chrono::hours>;
+    typename T::rep;
+    typename T::period;
+    requires std::is_same_v<T, std::chrono::duration<typename T::rep, typename T::period>>;
+    requires std::is_arithmetic_v<typename T::rep>;
+    requires std::is_same_v<typename T::period, std::nano> ||
+             std::is_same_v<typename T::period, std::micro> ||
+             std::is_same_v<typename T::period, std::milli> ||
+             std::is_same_v<typename T::period, std::ratio<1>> ||
+             std::is_same_v<typename T::period, std::ratio<60>> ||
+             std::is_same_v<typename T::period, std::ratio<3600>>;
 };
 
+// Floating-point duration with the same period, e.g. Fractional<std::chrono::nanoseconds> keeps 0.25 ns
+template <ChronoDuration Unit>
+using Fractional = std::chrono::duration<double, typename Unit::period>;
+
 template <typename T>
 concept HasSize = requires(const T& t) { { t.size() } -> std::convertible_to<std::size_t>; };
 
 template <ChronoDuration T>
 inline constexpr std::string_view get_unit_symbol() noexcept
 {
-    if constexpr (std::is_same_v<T, std::chrono::nanoseconds>) { return "ns"; }
-    else if constexpr (std::is_same_v<T, std::chrono::microseconds>) { return "μs"; }
-    else if constexpr (std::is_same_v<T, std::chrono::milliseconds>) { return "ms"; }
-    else if constexpr (std::is_same_v<T, std::chrono::seconds>) { return "s"; }
-    else if constexpr (std::is_same_v<T, std::chrono::minutes>) { return "min"; }
-    else if constexpr (std::is_same_v<T, std::chrono::hours>) { return "h"; }
+    using Period = typename T::period;
+    if constexpr (std::is_same_v<Period, std::nano>) { return "ns"; }
+    else if constexpr (std::is_same_v<Period, std::micro>) { return "μs"; }
+    else if constexpr (std::is_same_v<Period, std::milli>) { return "ms"; }
+    else if constexpr (std::is_same_v<Period, std::ratio<1>>) { return "s"; }
+    else if constexpr (std::is_same_v<Period, std::ratio<60>>) { return "min"; }
+    else if constexpr (std::is_same_v<Period, std::ratio<3600>>) { return "h"; }
     else { return "units"; }
 }
+
+template <typename C>
+concept ClockPolicy = requires(typename C::ticks t)
+{
+    { C::start() } noexcept -> std::same_as<typename C::ticks>;
+    { C::stop() } noexcept -> std::same_as<typename C::ticks>;
+    { C::to_nanoseconds(t) } noexcept -> std::convertible_to<double>;
+    { C::name() } noexcept -> std::convertible_to<std::string_view>;
+};
 // clang-format on
 
+struct SteadyClock
+{
+    using ticks = std::chrono::steady_clock::rep;
+
+    static ticks start() noexcept { return std::chrono::steady_clock::now().time_since_epoch().count(); }
+    static ticks stop() noexcept { return std::chrono::steady_clock::now().time_since_epoch().count(); }
+
+    static double to_nanoseconds(ticks elapsed) noexcept
+    {
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::duration(elapsed)).count();
+    }
+
+    static constexpr std::string_view name() noexcept { return "steady_clock"; }
+};
+
+namespace detail
+{
+
+inline bool detect_invariant_tsc() noexcept
+{
+#if SRA_HAS_TSC
+#    if defined(_MSC_VER)
+    int regs[4] = {};
+    __cpuid(regs, static_cast<int>(0x80000000));
+    if (static_cast<unsigned>(regs[0]) < 0x80000007u) return false;
+    __cpuid(regs, static_cast<int>(0x80000007));
+    return (regs[3] & (1 << 8)) != 0;
+#    else
+    unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (__get_cpuid_max(0x80000000u, nullptr) < 0x80000007u) return false;
+    __get_cpuid(0x80000007u, &eax, &ebx, &ecx, &edx);
+    return (edx & (1u << 8)) != 0;
+#    endif
+#else
+    return false;
+#endif
+}
+
+} // namespace detail
+
+// Invariant TSC backend (rdtsc/rdtscp with fences). Falls back to steady_clock when the CPU has no invariant TSC
+struct TscClock
+{
+    using ticks = std::uint64_t;
+
+    static bool available() noexcept
+    {
+        static const bool invariant = detail::detect_invariant_tsc();
+        return invariant;
+    }
+
+    static ticks start() noexcept
+    {
+#if SRA_HAS_TSC
+        if (available())
+        {
+            _mm_lfence();
+            const ticks t = __rdtsc();
+            _mm_lfence();
+            return t;
+        }
+#endif
+        return static_cast<ticks>(SteadyClock::start());
+    }
+
+    static ticks stop() noexcept
+    {
+#if SRA_HAS_TSC
+        if (available())
+        {
+            unsigned int aux = 0;
+            const ticks t = __rdtscp(&aux);
+            _mm_lfence();
+            return t;
+        }
+#endif
+        return static_cast<ticks>(SteadyClock::stop());
+    }
+
+    static double to_nanoseconds(ticks elapsed) noexcept
+    {
+        if (!available()) return SteadyClock::to_nanoseconds(static_cast<SteadyClock::ticks>(elapsed));
+        return static_cast<double>(elapsed) * nanoseconds_per_tick();
+    }
+
+    // Calibrated once against steady_clock on first use
+    static double nanoseconds_per_tick() noexcept
+    {
+        static const double ratio = [] {
+            const auto wall_start = std::chrono::steady_clock::now();
+            const ticks tsc_start = start();
+            while (std::chrono::steady_clock::now() - wall_start < std::chrono::milliseconds(20)) {}
+            const ticks tsc_end = stop();
+            const auto wall_end = std::chrono::steady_clock::now();
+            const double wall_ns = std::chrono::duration<double, std::nano>(wall_end - wall_start).count();
+            return tsc_end > tsc_start ? wall_ns / static_cast<double>(tsc_end - tsc_start) : 1.0;
+        }();
+        return ratio;
+    }
+
+    static constexpr std::string_view name() noexcept { return "tsc"; }
+};
+
+// Cost of an empty timed region, measured once per clock and subtracted from every measurement
+template <ClockPolicy Clock>
+[[nodiscard]] std::chrono::duration<double, std::nano> timer_overhead() noexcept
+{
+    static const double overhead_ns = [] {
+        constexpr int calibration_runs = 1000;
+        double best = std::numeric_limits<double>::infinity();
+        for (int i = 0; i < calibration_runs; ++i)
+        {
+            const auto start = Clock::start();
+            const auto end = Clock::stop();
+            best = std::min(best, static_cast<double>(Clock::to_nanoseconds(end - start)));
+        }
+        return std::max(best, 0.0);
+    }();
+    return std::chrono::duration<double, std::nano>(overhead_ns);
+}
+
+// Work one call does on a sample, for the items/s, GB/s and ns/item columns of reports
+struct Throughput
+{
+    std::uint64_t items = 0;
+    std::uint64_t bytes = 0; // Bytes read and written, 0 when unknown
+};
+
+struct MeasurementPolicy
+{
+    size_t warmup_runs = 0;
+    size_t repetitions = 1;
+
+    // Auto-repeat: keep measuring past `repetitions` until the 95% confidence interval of the mean is
+    // within `target_relative_ci` of the mean, `max_repetitions` is reached or `time_budget` is spent
+    bool auto_repeat = false;
+    size_t max_repetitions = 1000;
+    double target_relative_ci = 0.02;
+    std::chrono::nanoseconds time_budget = std::chrono::seconds(1);
+
+    // Batch mode: each timed region runs the callable `batch_size` times and the time per call is stored.
+    // A batch_size of 0 picks the size per sample so that a region lasts at least `min_batch_time`
+    size_t batch_size = 1;
+    std::chrono::nanoseconds min_batch_time = std::chrono::milliseconds(1);
+
+    // Record cycles, instructions, cache misses, branch misses and page faults around each timed region
+    bool collect_hardware_counters = false;
+
+    // Record allocation count, bytes and peak live bytes per sample (requires SRA_ALLOCATION_HOOKS)
+    bool track_allocations = false;
+
+    // Record the wall-clock span of each timed region, so trace reports show when every repetition ran
+    bool record_timeline = false;
+
+    // Histogram storage: record the repetitions of each sample into a fixed-size LatencyHistogram instead of keeping
+    // every one, so millions of repetitions per sample take constant memory. Percentiles are then within
+    // 2^-(histogram_precision_bits + 1) of a measured time
+    bool histogram_storage = false;
+    unsigned histogram_precision_bits = LatencyHistogram::default_precision_bits;
+
+    // Cache state each timed region starts in, set up outside the region. Cold mode sweeps a buffer of
+    // `eviction_buffer_bytes` (0 sizes it at twice the last-level cache) and, with `flush_sample`, also flushes the
+    // cache lines of the input
+    CacheMode cache_mode = CacheMode::unchanged;
+    bool flush_sample = false;
+    size_t eviction_buffer_bytes = 0;
+
+    // Record the work of one call per sample: size() items of sizeof(value) bytes each for a range, or whatever
+    // `throughput_of(sample_size)` returns when it is set, e.g. to count the bytes a sort reads and writes
+    bool record_throughput = false;
+    std::function<Throughput(size_t sample_size)> throughput_of{};
+};
+
+// Wall-clock span of one timed region, relative to the trace epoch of the process
+struct TimedSpan
+{
+    std::chrono::nanoseconds start{};
+    std::chrono::nanoseconds end{};
+};
+
+// Resource usage of the child process that measured a sample in isolation
+struct ProcessUsage
+{
+    std::size_t max_rss_bytes = 0;          // Peak resident set, including the memory inherited from the parent
+    std::uint64_t voluntary_switches = 0;   // Context switches while measuring, e.g. blocking on I/O or a lock
+    std::uint64_t involuntary_switches = 0; // Preemptions while measuring
+};
+
+template <ChronoDuration Unit>
+struct SampleStatistics
+{
+    using FractionalUnit = Fractional<Unit>;
+
+    size_t sample_size = 0;
+    size_t repetitions = 0;
+    FractionalUnit min{};
+    FractionalUnit median{};
+    FractionalUnit mean{};
+    FractionalUnit stddev{};
+    FractionalUnit mad{};
+    FractionalUnit p90{};
+    FractionalUnit p99{};
+};
+
+namespace detail
+{
+
+// Linear interpolation between closest ranks, expects sorted input
+inline double percentile_sorted(std::span<const double> sorted, double fraction) noexcept
+{
+    if (sorted.empty()) return 0.0;
+    const double rank = fraction * static_cast<double>(sorted.size() - 1);
+    const auto lower = static_cast<size_t>(std::floor(rank));
+    const auto upper = std::min(lower + 1, sorted.size() - 1);
+    return sorted[lower] + (rank - static_cast<double>(lower)) * (sorted[upper] - sorted[lower]);
+}
+
+// Two-sided 95% Student t quantile, falls back to the normal quantile for large samples
+inline double student_t_975(size_t degrees_of_freedom) noexcept
+{
+    static constexpr double table[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                       2.201,  2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                       2.080,  2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+    if (degrees_of_freedom == 0) return table[0];
+    if (degrees_of_freedom <= std::size(table)) return table[degrees_of_freedom - 1];
+    return 1.960;
+}
+
+template <ChronoDuration Unit>
+[[nodiscard]] SampleStatistics<Unit> compute_statistics(std::span<const Unit> durations, size_t sample_size)
+{
+    using FractionalUnit = typename SampleStatistics<Unit>::FractionalUnit;
+
+    SampleStatistics<Unit> stats;
+    stats.sample_size = sample_size;
+    stats.repetitions = durations.size();
+    if (durations.empty()) return stats;
+
+    std::vector<double> values;
+    values.reserve(durations.size());
+    for (const auto& duration : durations) { values.push_back(static_cast<double>(duration.count())); }
+    std::ranges::sort(values);
+
+    double sum = 0.0;
+    for (double v : values) { sum += v; }
+    const double mean = sum / static_cast<double>(values.size());
+
+    double squared = 0.0;
+    for (double v : values) { squared += (v - mean) * (v - mean); }
+    const double variance = values.size() > 1 ? squared / static_cast<double>(values.size() - 1) : 0.0;
+
+    const double median = percentile_sorted(values, 0.5);
+    std::vector<double> deviations;
+    deviations.reserve(values.size());
+    for (double v : values) { deviations.push_back(std::abs(v - median)); }
+    std::ranges::sort(deviations);
+
+    stats.min = FractionalUnit{values.front()};
+    stats.median = FractionalUnit{median};
+    stats.mean = FractionalUnit{mean};
+    stats.stddev = FractionalUnit{std::sqrt(variance)};
+    stats.mad = FractionalUnit{percentile_sorted(deviations, 0.5)};
+    stats.p90 = FractionalUnit{percentile_sorted(values, 0.90)};
+    stats.p99 = FractionalUnit{percentile_sorted(values, 0.99)};
+    return stats;
+}
+
+// Statistics of a sample stored as a histogram of nanoseconds, each repetition taken at the middle of its bucket
+template <ChronoDuration Unit>
+[[nodiscard]] SampleStatistics<Unit> histogram_statistics(const LatencyHistogram& histogram, size_t sample_size)
+{
+    using FractionalUnit = typename SampleStatistics<Unit>::FractionalUnit;
+    const auto in_unit = [](double nanoseconds) {
+        return std::chrono::duration_cast<FractionalUnit>(std::chrono::duration<double, std::nano>(nanoseconds));
+    };
+
+    SampleStatistics<Unit> stats;
+    stats.sample_size = sample_size;
+    stats.repetitions = static_cast<size_t>(histogram.count());
+    if (histogram.empty()) return stats;
+
+    stats.min = in_unit(static_cast<double>(histogram.min()));
+    stats.median = in_unit(histogram.percentile(0.5));
+    stats.mean = in_unit(histogram.mean());
+    stats.stddev = in_unit(histogram.stddev());
+    stats.mad = in_unit(histogram.median_absolute_deviation());
+    stats.p90 = in_unit(histogram.percentile(0.90));
+    stats.p99 = in_unit(histogram.percentile(0.99));
+    return stats;
+}
+
+// Common origin of recorded timelines and zone events, fixed on first use
+[[nodiscard]] inline std::chrono::steady_clock::time_point trace_epoch() noexcept
+{
+    static const auto epoch = std::chrono::steady_clock::now();
+    return epoch;
+}
+
+[[nodiscard]] inline std::chrono::nanoseconds trace_time() noexcept
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - trace_epoch());
+}
+
+template <ChronoDuration Unit>
+[[nodiscard]] Unit median_of(std::span<const Unit> durations)
+{
+    if (durations.empty()) return Unit::zero();
+
+    std::vector<Unit> sorted(durations.begin(), durations.end());
+    std::ranges::sort(sorted);
+    const size_t mid = sorted.size() / 2;
+    if (sorted.size() % 2 != 0) return sorted[mid];
+    return Unit{(sorted[mid - 1].count() + sorted[mid].count()) / 2};
+}
+
+// An optional column of a profile is either empty or holds one entry per sample, so reports can index it by sample
+inline void check_column(size_t column_size, bool present, size_t index, std::string_view name)
+{
+    if (present && column_size != index)
+    {
+        throw std::invalid_argument("Sample " + std::to_string(index + 1) + " has " + std::string(name) +
+                                    " but earlier samples of the profile do not");
+    }
+    if (!present && column_size != 0)
+    {
+        throw std::invalid_argument("Sample " + std::to_string(index + 1) + " has no " + std::string(name) +
+                                    " but earlier samples of the profile do");
+    }
+}
+
+} // namespace detail
+
+// Everything recorded for one sample, appended to a RuntimeProfile in sample order
+template <ChronoDuration Unit>
+struct SampleMeasurement
+{
+    size_t sample_size = 0;
+    std::vector<Unit> repetitions;
+    std::optional<HardwareCounters> counters;
+    std::optional<AllocationStats> allocations;
+    std::optional<int> cpu_id;
+    std::optional<CacheMode> cache_mode; // Set when the policy conditions the caches
+    std::optional<ProcessUsage> process_usage;
+    std::optional<Throughput> throughput; // Set when the policy records throughput
+    std::vector<TimedSpan> timeline; // One span per repetition when the policy records the timeline
+
+    // Repetitions in nanoseconds with histogram storage, which leaves `repetitions` empty
+    std::optional<LatencyHistogram> histogram;
+};
+
 template <ChronoDuration Unit>
 struct RuntimeProfile
 {
-    std::vector<Unit> raw_durations;
+    std::vector<Unit> raw_durations; // Median of the repetitions of each sample
     std::vector<size_t> sample_sizes;
+    std::vector<std::vector<Unit>> repetitions;
+    std::vector<HardwareCounters> counters;       // Empty when counters were not collected
+    std::vector<AllocationStats> allocations;     // Empty when allocations were not tracked
+    std::vector<int> cpu_ids;                     // Core that measured each sample, empty for sequential profiles
+    std::vector<CacheMode> cache_modes;           // Cache state of each sample, empty when it was left unchanged
+    std::vector<ProcessUsage> process_usage;      // Child process of each sample, empty unless measured in isolation
+    std::vector<Throughput> throughput;           // Work of one call per sample, empty when it was not recorded
+    std::vector<std::vector<TimedSpan>> timeline; // Span of each repetition, empty when the timeline was not recorded
+    std::vector<LatencyHistogram> histograms;     // Repetitions in nanoseconds, empty without histogram storage
+    std::optional<ComplexityAnalysis> complexity; // Set from fit_complexity() to include the fit in reports
+    std::optional<double> peak_bandwidth;         // Bytes per second, e.g. from measure_stream_bandwidth()
     std::string unit_symbol;
 
+    // Empty profile, filled with append()
+    RuntimeProfile() : unit_symbol(get_unit_symbol<Unit>()) {}
+
     // Main constructor
-    RuntimeProfile(std::vector<Unit>&& _raw_durations, std::vector<size_t>&& _sample_sizes) noexcept
+    RuntimeProfile(std::vector<Unit>&& _raw_durations, std::vector<size_t>&& _sample_sizes)
         : raw_durations(std::move(_raw_durations))
         , sample_sizes(std::move(_sample_sizes))
         , unit_symbol(get_unit_symbol<Unit>())
-    {}
+    {
+        repetitions.reserve(raw_durations.size());
+        for (const auto& duration : raw_durations) { repetitions.push_back({duration}); }
+    }
+
+    // Repetitions constructor
+    RuntimeProfile(std::vector<std::vector<Unit>>&& _repetitions, std::vector<size_t>&& _sample_sizes)
+        : sample_sizes(std::move(_sample_sizes))
+        , repetitions(std::move(_repetitions))
+        , unit_symbol(get_unit_symbol<Unit>())
+    {
+        raw_durations.reserve(repetitions.size());
+        for (const auto& runs : repetitions) { raw_durations.push_back(detail::median_of<Unit>(runs)); }
+    }
 
     // Conversion constructor
     template <ChronoDuration OtherUnit>
     explicit RuntimeProfile(const RuntimeProfile<OtherUnit>& other)
-        : sample_sizes(other.sample_sizes), unit_symbol(get_unit_symbol<Unit>())
+        : sample_sizes(other.sample_sizes)
+        , counters(other.counters)
+        , allocations(other.allocations)
+        , cpu_ids(other.cpu_ids)
+        , cache_modes(other.cache_modes)
+        , process_usage(other.process_usage)
+        , throughput(other.throughput)
+        , timeline(other.timeline)
+        , histograms(other.histograms)
+        , complexity(other.complexity)
+        , peak_bandwidth(other.peak_bandwidth)
+        , unit_symbol(get_unit_symbol<Unit>())
     {
+        if (complexity)
+        {
+            using Ratio = std::ratio_divide<typename OtherUnit::period, typename Unit::period>;
+            complexity->rescale(static_cast<double>(Ratio::num) / static_cast<double>(Ratio::den));
+        }
+
         raw_durations.reserve(other.raw_durations.size());
-        if constexpr (std::is_same_v<Unit, OtherUnit>) { raw_durations = other.raw_durations; }
+        repetitions.reserve(other.repetitions.size());
+        if constexpr (std::is_same_v<Unit, OtherUnit>)
+        {
+            raw_durations = other.raw_durations;
+            repetitions = other.repetitions;
+        }
         else
         {
             for (const auto& t : other.raw_durations) { raw_durations.push_back(std::chrono::duration_cast<Unit>(t)); }
+            for (const auto& runs : other.repetitions)
+            {
+                auto& converted = repetitions.emplace_back();
+                converted.reserve(runs.size());
+                for (const auto& t : runs) { converted.push_back(std::chrono::duration_cast<Unit>(t)); }
+            }
         }
     }
 
@@ -89,64 +540,673 @@ struct RuntimeProfile
         return RuntimeProfile<UnitTo>(*this);
     }
 
+    // Optional columns stay aligned with the samples: counters missing from a sample are recorded as unavailable, and
+    // any other field present in only some samples throws std::invalid_argument. Every field is checked before the
+    // profile changes, so a rejected sample leaves it as it was
+    void append(SampleMeasurement<Unit>&& measurement)
+    {
+        const size_t index = sample_sizes.size();
+        detail::check_column(allocations.size(), measurement.allocations.has_value(), index, "allocations");
+        detail::check_column(cpu_ids.size(), measurement.cpu_id.has_value(), index, "a cpu_id");
+        detail::check_column(cache_modes.size(), measurement.cache_mode.has_value(), index, "a cache_mode");
+        detail::check_column(process_usage.size(), measurement.process_usage.has_value(), index, "process usage");
+        detail::check_column(throughput.size(), measurement.throughput.has_value(), index, "throughput");
+        detail::check_column(histograms.size(), measurement.histogram.has_value(), index, "a histogram");
+
+        if (measurement.counters || !counters.empty())
+        {
+            counters.resize(index);
+            counters.push_back(measurement.counters.value_or(HardwareCounters{}));
+        }
+        if (measurement.allocations) { allocations.push_back(*measurement.allocations); }
+        if (measurement.cpu_id) { cpu_ids.push_back(*measurement.cpu_id); }
+        if (measurement.cache_mode) { cache_modes.push_back(*measurement.cache_mode); }
+        if (measurement.process_usage) { process_usage.push_back(*measurement.process_usage); }
+        if (measurement.throughput) { throughput.push_back(*measurement.throughput); }
+
+        if (measurement.histogram)
+        {
+            const std::chrono::duration<double, std::nano> median(measurement.histogram->percentile(0.5));
+            raw_durations.push_back(std::chrono::duration_cast<Unit>(median));
+            histograms.push_back(std::move(*measurement.histogram));
+        }
+        else { raw_durations.push_back(detail::median_of<Unit>(measurement.repetitions)); }
+        sample_sizes.push_back(measurement.sample_size);
+        repetitions.push_back(std::move(measurement.repetitions));
+        if (!measurement.timeline.empty()) { timeline.push_back(std::move(measurement.timeline)); }
+
+        // A fit of the earlier samples has no residual for this one and may no longer be the best class
+        complexity.reset();
+    }
+
+    void reserve(std::size_t sample_count)
+    {
+        raw_durations.reserve(sample_count);
+        sample_sizes.reserve(sample_count);
+        repetitions.reserve(sample_count);
+    }
+
+    // Statistics over the repetitions of one sample, or over its histogram with histogram storage
+    [[nodiscard]] SampleStatistics<Unit> statistics(std::size_t index) const
+    {
+        if (index >= repetitions.size()) { throw std::out_of_range("Sample index out of range"); }
+        if (repetitions[index].empty() && index < histograms.size())
+        {
+            return detail::histogram_statistics<Unit>(histograms[index], sample_sizes[index]);
+        }
+        return detail::compute_statistics<Unit>(repetitions[index], sample_sizes[index]);
+    }
+
+    // Statistics for every sample, in sample order
+    [[nodiscard]] std::vector<SampleStatistics<Unit>> statistics() const
+    {
+        std::vector<SampleStatistics<Unit>> result;
+        result.reserve(repetitions.size());
+        for (std::size_t i = 0; i < repetitions.size(); ++i) { result.push_back(statistics(i)); }
+        return result;
+    }
+
     // Utility methods
     [[nodiscard]] std::size_t size() const noexcept { return raw_durations.size(); }
     [[nodiscard]] bool empty() const noexcept { return raw_durations.empty(); }
 };
 
-template <ChronoDuration Unit = std::chrono::milliseconds, typename Func, typename... Args>
-requires std::invocable<Func, Args...>
-[[nodiscard]] auto measure_duration(Func&& func, Args&&... args)
+// Receives each measurement as soon as profile_runtime completes it. completed() returns true for sample sizes the
+// sink already holds, e.g. from an earlier run it resumes, and those samples are not measured again
+template <typename Sink, typename Unit>
+concept MeasurementSink = ChronoDuration<Unit> && requires(Sink& sink, SampleMeasurement<Unit>&& measurement) {
+    { sink.completed(size_t{}) } -> std::convertible_to<bool>;
+    sink.push(std::move(measurement));
+};
+
+// Prevents the compiler from discarding `value` or the computation that produced it
+template <typename T>
+inline void do_not_optimize(const T& value) noexcept
+{
+#if defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#elif defined(__GNUC__)
+    if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(void*))
+    {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+    else { asm volatile("" : : "m"(value) : "memory"); }
+#else
+    const volatile char* volatile sink = &reinterpret_cast<const volatile char&>(value);
+    static_cast<void>(sink);
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+template <typename T>
+inline void do_not_optimize(T& value) noexcept
 {
-    const auto start = std::chrono::high_resolution_clock::now();
+#if defined(__clang__)
+    asm volatile("" : "+r,m"(value) : : "memory");
+#elif defined(__GNUC__)
+    if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(void*))
+    {
+        asm volatile("" : "+m,r"(value) : : "memory");
+    }
+    else { asm volatile("" : "+m"(value) : : "memory"); }
+#else
+    do_not_optimize(static_cast<const T&>(value));
+#endif
+}
 
+// Forces pending writes to memory and prevents the compiler from caching values across the barrier
+inline void clobber_memory() noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#else
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+// Default setup of a Fixture: copies the sample into the reused input. Containers are assigned in place, so once an
+// input has grown to the sample size the copy is a memcpy for trivially copyable elements and never allocates
+struct CopyInput
+{
+    template <typename Sample, typename Input>
+    void operator()(const Sample& sample, Input& input) const
+    {
+        if constexpr (requires { input.assign(std::ranges::begin(sample), std::ranges::end(sample)); })
+        {
+            input.assign(std::ranges::begin(sample), std::ranges::end(sample));
+        }
+        else { input = sample; }
+    }
+};
+
+struct NoTeardown
+{
+    template <typename Input>
+    void operator()(Input&) const noexcept {}
+};
+
+// Benchmark whose timed call consumes its input, e.g. an in-place sort. Before each timed region, setup(sample, input)
+// prepares a fresh input for every call of the region, body(input) is timed, and teardown(input) runs after the
+// region. Inputs come from a pool kept across repetitions and samples, so preparing them reuses the same memory
+template <typename Body, typename Setup = CopyInput, typename Teardown = NoTeardown>
+struct Fixture
+{
+    Body body;
+    Setup setup{};
+    Teardown teardown{};
+};
+
+namespace detail
+{
+
+// Invokes the callable and keeps its result observable
+template <typename Func, typename... Args>
+inline void invoke_and_keep(Func&& func, Args&&... args)
+{
     if constexpr (std::is_void_v<std::invoke_result_t<Func, Args...>>)
     {
         std::invoke(std::forward<Func>(func), std::forward<Args>(args)...);
     }
     else
     {
-        [[maybe_unused]] auto result = std::invoke(std::forward<Func>(func), std::forward<Args>(args)...);
+        auto&& result = std::invoke(std::forward<Func>(func), std::forward<Args>(args)...);
+        do_not_optimize(result);
     }
+}
 
-    const auto end = std::chrono::high_resolution_clock::now();
-    return std::chrono::duration_cast<Unit>(end - start);
+template <ChronoDuration Unit>
+[[nodiscard]] Unit from_nanoseconds(double nanoseconds) noexcept
+{
+    return std::chrono::duration_cast<Unit>(std::chrono::duration<double, std::nano>(nanoseconds));
 }
 
+} // namespace detail
+
 template <ChronoDuration Unit = std::chrono::milliseconds,
+          ClockPolicy Clock = SteadyClock,
+          typename Func,
+          typename... Args>
+requires std::invocable<Func, Args...>
+[[nodiscard]] auto measure_duration(Func&& func, Args&&... args)
+{
+    const auto overhead_ns = timer_overhead<Clock>().count();
+    const auto start = Clock::start();
+
+    detail::invoke_and_keep(std::forward<Func>(func), std::forward<Args>(args)...);
+
+    const auto end = Clock::stop();
+    const double elapsed_ns = std::max(static_cast<double>(Clock::to_nanoseconds(end - start)) - overhead_ns, 0.0);
+    return detail::from_nanoseconds<Unit>(elapsed_ns);
+}
+
+namespace detail
+{
+
+inline void validate_policy(const MeasurementPolicy& policy)
+{
+    if (policy.repetitions == 0) { throw std::invalid_argument("Measurement policy requires at least one repetition"); }
+    if (policy.auto_repeat && policy.max_repetitions < policy.repetitions)
+    {
+        throw std::invalid_argument("Measurement policy max_repetitions is lower than repetitions");
+    }
+    if (policy.batch_size == 0 && policy.min_batch_time <= std::chrono::nanoseconds::zero())
+    {
+        throw std::invalid_argument("Measurement policy automatic batch size requires a positive min_batch_time");
+    }
+    const auto precision = policy.histogram_precision_bits;
+    if (policy.histogram_storage && (precision == 0 || precision > LatencyHistogram::max_precision_bits))
+    {
+        throw std::invalid_argument("Measurement policy histogram_precision_bits must be between 1 and 16");
+    }
+}
+
+// Half-width of the 95% confidence interval of the mean relative to the mean
+template <ChronoDuration Unit>
+[[nodiscard]] double relative_confidence_interval(std::span<const Unit> durations) noexcept
+{
+    if (durations.size() < 2) return std::numeric_limits<double>::infinity();
+
+    double sum = 0.0;
+    for (const auto& d : durations) { sum += static_cast<double>(d.count()); }
+    const double n = static_cast<double>(durations.size());
+    const double mean = sum / n;
+    if (mean <= 0.0) return 0.0;
+
+    double squared = 0.0;
+    for (const auto& d : durations)
+    {
+        const double delta = static_cast<double>(d.count()) - mean;
+        squared += delta * delta;
+    }
+    const double standard_error = std::sqrt(squared / (n - 1.0)) / std::sqrt(n);
+    return student_t_975(durations.size() - 1) * standard_error / mean;
+}
+
+// Running mean and variance (Welford) of the repetitions of a sample being measured, so the auto-repeat check costs
+// the same at every repetition and works without keeping them
+struct RunningMoments
+{
+    size_t count = 0;
+    double mean = 0.0;
+    double squared = 0.0;
+
+    void add(double value) noexcept
+    {
+        ++count;
+        const double delta = value - mean;
+        mean += delta / static_cast<double>(count);
+        squared += delta * (value - mean);
+    }
+
+    // Same as relative_confidence_interval over the values added so far
+    [[nodiscard]] double relative_confidence_interval() const noexcept
+    {
+        if (count < 2) return std::numeric_limits<double>::infinity();
+        if (mean <= 0.0) return 0.0;
+        const double n = static_cast<double>(count);
+        const double standard_error = std::sqrt(std::max(squared, 0.0) / (n - 1.0)) / std::sqrt(n);
+        return student_t_975(count - 1) * standard_error / mean;
+    }
+};
+
+// Optional instruments started right before and stopped right after every timed region
+struct MeasurementProbes
+{
+    std::unique_ptr<PerfCounterGroup> counters;
+    bool track_allocations = false;
+    AllocationTotals allocations;
+    std::optional<CacheConditioner> cache;
+};
+
+// Untimed preparation of the calls of a timed region, for invocables that have it like FixtureCalls
+template <typename Invoke>
+void before_region(Invoke& invoke, size_t iterations)
+{
+    if constexpr (requires { invoke.before_region(iterations); }) { invoke.before_region(iterations); }
+}
+
+template <typename Invoke>
+void after_region(Invoke& invoke, size_t iterations)
+{
+    if constexpr (requires { invoke.after_region(iterations); }) { invoke.after_region(iterations); }
+}
+
+// Cache conditioning before a timed region, over the inputs of its calls for invocables that expose them
+template <typename Invoke>
+void condition_cache(Invoke& invoke, size_t iterations, MeasurementProbes* probes)
+{
+    if (!probes || !probes->cache) return;
+    probes->cache->prepare([&invoke, iterations](auto&& visit) {
+        if constexpr (requires { invoke.for_each_input(iterations, visit); })
+        {
+            invoke.for_each_input(iterations, visit);
+        }
+    });
+}
+
+// Calls of a callable on one sample
+template <typename Func, typename Sample>
+struct SampleCalls
+{
+    Func& func;
+    const Sample& sample;
+
+    template <typename Visit>
+    void for_each_input(size_t, Visit&& visit) const
+    {
+        visit(input_bytes(sample));
+    }
+
+    void operator()() { func(sample); }
+};
+
+// Calls of a fixture on one sample. Each call of a timed region gets its own input from the pool, prepared before
+// the region starts
+template <typename FixtureType, typename Sample, typename Input>
+struct FixtureCalls
+{
+    FixtureType& fixture;
+    const Sample& sample;
+    std::vector<Input>& inputs;
+    size_t next = 0;
+
+    void before_region(size_t iterations)
+    {
+        if (inputs.size() < iterations) { inputs.resize(iterations); }
+        for (size_t i = 0; i < iterations; ++i) { fixture.setup(sample, inputs[i]); }
+        next = 0;
+    }
+
+    void after_region(size_t iterations)
+    {
+        for (size_t i = 0; i < iterations; ++i) { fixture.teardown(inputs[i]); }
+    }
+
+    template <typename Visit>
+    void for_each_input(size_t iterations, Visit&& visit) const
+    {
+        for (size_t i = 0; i < iterations; ++i) { visit(input_bytes(inputs[i])); }
+    }
+
+    void operator()() { invoke_and_keep(fixture.body, inputs[next++]); }
+};
+
+// Work of one call on `sample` when the policy records throughput. A range holds size() items of its value type,
+// other samples have size() items of unknown size
+template <typename Sample>
+[[nodiscard]] std::optional<Throughput> sample_throughput(const MeasurementPolicy& policy, const Sample& sample)
+{
+    if (policy.throughput_of) { return policy.throughput_of(sample.size()); }
+    if (!policy.record_throughput) { return std::nullopt; }
+
+    Throughput throughput{.items = static_cast<std::uint64_t>(sample.size())};
+    if constexpr (std::ranges::sized_range<const Sample>)
+    {
+        throughput.bytes = throughput.items * sizeof(std::ranges::range_value_t<const Sample>);
+    }
+    return throughput;
+}
+
+// Elapsed nanoseconds of one timed region running `invoke` `iterations` times, minus the timer overhead
+template <ClockPolicy Clock, typename Invoke>
+[[nodiscard]] double timed_batch_ns(Invoke& invoke, size_t iterations, MeasurementProbes* probes = nullptr)
+{
+    const auto overhead_ns = timer_overhead<Clock>().count();
+    if (probes)
+    {
+        if (probes->counters) { probes->counters->start(); }
+        if (probes->track_allocations) { begin_allocation_region(); }
+    }
+
+    const auto start = Clock::start();
+    for (size_t i = 0; i < iterations; ++i) { invoke(); }
+    const auto end = Clock::stop();
+
+    if (probes)
+    {
+        if (probes->track_allocations)
+        {
+            end_allocation_region();
+            probes->allocations.add_region();
+        }
+        if (probes->counters) { probes->counters->stop(); }
+    }
+    return std::max(static_cast<double>(Clock::to_nanoseconds(end - start)) - overhead_ns, 0.0);
+}
+
+// Grows the batch until one timed region lasts at least min_batch_time, in the cache state of the measurement
+template <ClockPolicy Clock, typename Invoke>
+[[nodiscard]] size_t
+calibrate_batch_size(const MeasurementPolicy& policy, Invoke& invoke, MeasurementProbes* probes = nullptr)
+{
+    constexpr size_t max_batch_size = size_t{1} << 30;
+    const double target_ns = std::chrono::duration<double, std::nano>(policy.min_batch_time).count();
+
+    size_t batch = 1;
+    while (batch < max_batch_size)
+    {
+        before_region(invoke, batch);
+        condition_cache(invoke, batch, probes);
+        const double elapsed_ns = timed_batch_ns<Clock>(invoke, batch);
+        after_region(invoke, batch);
+        if (elapsed_ns >= target_ns) { break; }
+
+        const double growth = elapsed_ns > 0.0 ? std::clamp(1.2 * target_ns / elapsed_ns, 2.0, 10.0) : 10.0;
+        batch = std::min(static_cast<size_t>(static_cast<double>(batch) * growth), max_batch_size);
+    }
+    return batch;
+}
+
+template <ChronoDuration Unit, ClockPolicy Clock, typename Invoke>
+[[nodiscard]] SampleMeasurement<Unit>
+measure_sample(const MeasurementPolicy& policy, Invoke&& invoke, MeasurementProbes* probes = nullptr)
+{
+    for (size_t i = 0; i < policy.warmup_runs; ++i)
+    {
+        before_region(invoke, 1);
+        invoke();
+        after_region(invoke, 1);
+    }
+
+    const size_t batch =
+        policy.batch_size != 0 ? policy.batch_size : calibrate_batch_size<Clock>(policy, invoke, probes);
+
+    SampleMeasurement<Unit> measurement;
+    if (probes && probes->cache) { measurement.cache_mode = probes->cache->cache_mode(); }
+    auto& durations = measurement.repetitions;
+    const size_t expected = policy.auto_repeat ? std::max(policy.repetitions, size_t{16}) : policy.repetitions;
+    if (policy.histogram_storage) { measurement.histogram.emplace(policy.histogram_precision_bits); }
+    else { durations.reserve(expected); }
+
+    if (policy.record_timeline) { measurement.timeline.reserve(expected); }
+
+    RunningMoments moments;
+    const auto budget_start = std::chrono::steady_clock::now();
+    while (true)
+    {
+        before_region(invoke, batch);
+        condition_cache(invoke, batch, probes);
+        const auto region_start = policy.record_timeline ? trace_time() : std::chrono::nanoseconds{};
+        const double elapsed_ns = timed_batch_ns<Clock>(invoke, batch, probes);
+        if (policy.record_timeline) { measurement.timeline.push_back({region_start, trace_time()}); }
+        after_region(invoke, batch);
+
+        const double per_call_ns = elapsed_ns / static_cast<double>(batch);
+        if (measurement.histogram)
+        {
+            measurement.histogram->record(static_cast<std::uint64_t>(std::llround(per_call_ns)));
+            moments.add(per_call_ns);
+        }
+        else
+        {
+            durations.emplace_back(from_nanoseconds<Unit>(per_call_ns));
+            moments.add(static_cast<double>(durations.back().count()));
+        }
+
+        if (moments.count < policy.repetitions) { continue; }
+        if (!policy.auto_repeat || moments.count >= policy.max_repetitions) { break; }
+        if (moments.relative_confidence_interval() <= policy.target_relative_ci) { break; }
+        if (std::chrono::steady_clock::now() - budget_start >= policy.time_budget) { break; }
+    }
+
+    if (probes)
+    {
+        const size_t calls = moments.count * batch;
+        if (probes->counters) { measurement.counters = probes->counters->take(calls); }
+        if (probes->track_allocations) { measurement.allocations = probes->allocations.take(calls); }
+    }
+    return measurement;
+}
+
+// Sets up the probes requested by the policy, warning about the ones this process cannot provide
+[[nodiscard]] inline MeasurementProbes open_probes(const MeasurementPolicy& policy, bool report_warnings = true)
+{
+    MeasurementProbes probes;
+
+    if (policy.collect_hardware_counters)
+    {
+        auto group = std::make_unique<PerfCounterGroup>();
+        if (!group->available())
+        {
+            if (report_warnings)
+            {
+                std::cerr << "Warning: hardware counters disabled, measuring wall time only (" << group->status()
+                          << ")\n";
+            }
+        }
+        else
+        {
+            if (report_warnings && group->status() != "enabled")
+            {
+                std::cerr << "Warning: hardware counters " << group->status() << "\n";
+            }
+            probes.counters = std::move(group);
+        }
+    }
+
+    if (policy.track_allocations)
+    {
+        if (allocation_tracking_available()) { probes.track_allocations = true; }
+        else if (report_warnings)
+        {
+            std::cerr << "Warning: allocation tracking disabled, define SRA_ALLOCATION_HOOKS in one source file\n";
+        }
+    }
+
+    if (policy.cache_mode != CacheMode::unchanged)
+    {
+        probes.cache.emplace(policy.cache_mode, policy.flush_sample, policy.eviction_buffer_bytes);
+    }
+
+    return probes;
+}
+
+// Sink of the collecting profile_runtime overload
+template <ChronoDuration Unit>
+struct ProfileSink
+{
+    RuntimeProfile<Unit>& profile;
+
+    [[nodiscard]] bool completed(size_t) const noexcept { return false; }
+    void push(SampleMeasurement<Unit>&& measurement) { profile.append(std::move(measurement)); }
+};
+
+} // namespace detail
+
+// Pushes each measurement into `sink` as soon as it completes, without keeping the profile in memory.
+// Returns the number of samples measured, samples whose size the sink has completed are skipped
+template <ChronoDuration Unit = std::chrono::milliseconds,
+          ClockPolicy Clock = SteadyClock,
+          MeasurementSink<Unit> Sink,
           typename Func,
           std::ranges::range Container,
           typename... Args>
 requires HasSize<std::ranges::range_value_t<Container>> &&
          std::invocable<Func, const std::ranges::range_value_t<Container>&, Args...>
-[[nodiscard]] auto profile_runtime(Func&& func, const Container& samples, Args&&... args)
+size_t profile_runtime(
+    const MeasurementPolicy& policy, Sink& sink, Func&& func, const Container& samples, Args&&... args)
 {
     if (std::ranges::empty(samples))
     {
         throw std::invalid_argument("Cannot profile runtime with empty samples container");
     }
+    detail::validate_policy(policy);
 
-    std::vector<Unit> raw_durations;
-    std::vector<size_t> sample_sizes;
-    const auto num_samples = std::ranges::size(samples);
-
-    raw_durations.reserve(num_samples);
-    sample_sizes.reserve(num_samples);
+    auto probes = detail::open_probes(policy);
 
     // Capture arguments safely
     auto invoke_func = [&func, ... captured_args = std::forward<Args>(args)](const auto& sample) mutable {
-        std::invoke(func, sample, std::forward<Args>(captured_args)...);
+        detail::invoke_and_keep(func, sample, std::forward<Args>(captured_args)...);
     };
 
+    size_t measured = 0;
     for (const auto& sample : samples)
     {
-        auto duration = measure_duration<Unit>([&invoke_func, &sample]() { invoke_func(sample); });
+        if (sink.completed(sample.size())) { continue; }
 
-        raw_durations.emplace_back(duration);
-        sample_sizes.emplace_back(sample.size());
+        detail::SampleCalls<decltype(invoke_func), std::remove_cvref_t<decltype(sample)>> calls{invoke_func, sample};
+        auto measurement = detail::measure_sample<Unit, Clock>(policy, calls, &probes);
+        measurement.sample_size = sample.size();
+        measurement.throughput = detail::sample_throughput(policy, sample);
+        sink.push(std::move(measurement));
+        ++measured;
     }
 
-    return RuntimeProfile<Unit>{std::move(raw_durations), std::move(sample_sizes)};
+    return measured;
+}
+
+template <ChronoDuration Unit = std::chrono::milliseconds,
+          ClockPolicy Clock = SteadyClock,
+          typename Func,
+          std::ranges::range Container,
+          typename... Args>
+requires HasSize<std::ranges::range_value_t<Container>> &&
+         std::invocable<Func, const std::ranges::range_value_t<Container>&, Args...>
+[[nodiscard]] auto
+profile_runtime(const MeasurementPolicy& policy, Func&& func, const Container& samples, Args&&... args)
+{
+    RuntimeProfile<Unit> profile;
+    profile.reserve(std::ranges::size(samples));
+
+    detail::ProfileSink<Unit> sink{profile};
+    profile_runtime<Unit, Clock>(policy, sink, std::forward<Func>(func), samples, std::forward<Args>(args)...);
+
+    return profile;
+}
+
+template <ChronoDuration Unit = std::chrono::milliseconds,
+          ClockPolicy Clock = SteadyClock,
+          typename Func,
+          std::ranges::range Container,
+          typename... Args>
+requires HasSize<std::ranges::range_value_t<Container>> &&
+         std::invocable<Func, const std::ranges::range_value_t<Container>&, Args...>
+[[nodiscard]] auto profile_runtime(Func&& func, const Container& samples, Args&&... args)
+{
+    return profile_runtime<Unit, Clock>(
+        MeasurementPolicy{}, std::forward<Func>(func), samples, std::forward<Args>(args)...);
+}
+
+// Fixture overloads: only fixture.body is timed, on a fresh input prepared by fixture.setup for every call
+template <ChronoDuration Unit = std::chrono::milliseconds,
+          ClockPolicy Clock = SteadyClock,
+          MeasurementSink<Unit> Sink,
+          typename Body,
+          typename Setup,
+          typename Teardown,
+          std::ranges::range Container>
+requires HasSize<std::ranges::range_value_t<Container>> &&
+         std::invocable<Body&, std::ranges::range_value_t<Container>&>
+size_t profile_runtime(const MeasurementPolicy& policy,
+                       Sink& sink,
+                       Fixture<Body, Setup, Teardown> fixture,
+                       const Container& samples)
+{
+    using Sample = std::ranges::range_value_t<Container>;
+
+    if (std::ranges::empty(samples))
+    {
+        throw std::invalid_argument("Cannot profile runtime with empty samples container");
+    }
+    detail::validate_policy(policy);
+
+    auto probes = detail::open_probes(policy);
+    std::vector<Sample> inputs;
+
+    size_t measured = 0;
+    for (const auto& sample : samples)
+    {
+        if (sink.completed(sample.size())) { continue; }
+
+        detail::FixtureCalls<Fixture<Body, Setup, Teardown>, Sample, Sample> calls{fixture, sample, inputs};
+        auto measurement = detail::measure_sample<Unit, Clock>(policy, calls, &probes);
+        measurement.sample_size = sample.size();
+        measurement.throughput = detail::sample_throughput(policy, sample);
+        sink.push(std::move(measurement));
+        ++measured;
+    }
+
+    return measured;
+}
+
+template <ChronoDuration Unit = std::chrono::milliseconds,
+          ClockPolicy Clock = SteadyClock,
+          typename Body,
+          typename Setup,
+          typename Teardown,
+          std::ranges::range Container>
+requires HasSize<std::ranges::range_value_t<Container>> &&
+         std::invocable<Body&, std::ranges::range_value_t<Container>&>
+[[nodiscard]] auto
+profile_runtime(const MeasurementPolicy& policy, Fixture<Body, Setup, Teardown> fixture, const Container& samples)
+{
+    RuntimeProfile<Unit> profile;
+    profile.reserve(std::ranges::size(samples));
+
+    detail::ProfileSink<Unit> sink{profile};
+    profile_runtime<Unit, Clock>(policy, sink, std::move(fixture), samples);
+
+    return profile;
 }
 
 template <ChronoDuration Unit>
@@ -167,4 +1227,19 @@ template <ChronoDuration Unit>
     return Unit{total};
 }
 
-} // namespace sra
\ No newline at end of file
+// Least-squares fit of the median time of each sample against every complexity class, in the profile unit
+template <ChronoDuration Unit>
+[[nodiscard]] ComplexityAnalysis fit_complexity(const RuntimeProfile<Unit>& profile)
+{
+    std::vector<double> sizes, times;
+    sizes.reserve(profile.size());
+    times.reserve(profile.size());
+    for (const auto& [duration, size] : std::views::zip(profile.raw_durations, profile.sample_sizes))
+    {
+        sizes.push_back(static_cast<double>(size));
+        times.push_back(static_cast<double>(duration.count()));
+    }
+    return fit_complexity(sizes, times);
+}
+
+} // namespace sra
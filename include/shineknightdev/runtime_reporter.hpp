@@ -12,15 +12,34 @@
 
 #pragma once
 
+#include <array>
+#include <charconv>
 #include <cstddef>
+#include <cstdint>
 #include <filesystem>
+#include <format>
 #include <fstream>
+#include <initializer_list>
+#include <iterator>
+#include <map>
 #include <iostream>
+#include <optional>
 #include <ranges>
+#include <span>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
 
+#include "shineknightdev/binary_profile.hpp"
+#include "shineknightdev/regression_detector.hpp"
 #include "shineknightdev/runtime_analyzer.hpp"
+#include "shineknightdev/scaling_analyzer.hpp"
+#include "shineknightdev/trace_exporter.hpp"
+#include "shineknightdev/zone_profiler.hpp"
 
 namespace sra
 {
@@ -28,98 +47,705 @@ namespace sra
 namespace detail
 {
 
+// Optional column of the scaling and regression reports. An empty value is left blank in CSV, null in JSON, omitted
+// in text
+struct ExtraColumn
+{
+    std::string_view name;
+    std::optional<std::string> value;
+    bool quoted = false; // Text value, written as a string in JSON
+};
+
+[[nodiscard]] inline std::string json_value(const ExtraColumn& column)
+{
+    if (!column.value) return "null";
+    return column.quoted ? "\"" + escape_json(*column.value) + "\"" : *column.value;
+}
+
+inline std::optional<std::string> format_metric(const std::optional<double>& value)
+{
+    if (!value) return std::nullopt;
+    return std::format("{:.2f}", *value);
+}
+
+inline std::string format_fit(const ComplexityFit& fit)
+{
+    std::string text = std::format("{} | r_squared: {:.4f} | coefficient: {:.6g}", to_string(fit.complexity),
+                                   fit.r_squared, fit.coefficient);
+    if (fit.complexity == ComplexityClass::power_law) { text += std::format(" | exponent: {:.3f}", fit.exponent); }
+    else { text += std::format(" | intercept: {:.6g}", fit.intercept); }
+    return text;
+}
+
+inline void write_text_complexity(std::ostream& out, const ComplexityAnalysis& analysis)
+{
+    out << "Complexity: " << format_fit(analysis.best_fit()) << "\n";
+    for (const auto& fit : analysis.fits) { out << "  Fit " << format_fit(fit) << "\n"; }
+}
+
+inline void write_json_complexity(std::ostream& out, const ComplexityAnalysis& analysis)
+{
+    out << "  \"complexity\": {\n"
+        << "    \"best_fit\": \"" << to_string(analysis.best_fit().complexity) << "\",\n"
+        << "    \"fits\": [";
+    for (size_t i = 0; i < analysis.fits.size(); ++i)
+    {
+        const auto& fit = analysis.fits[i];
+        out << (i > 0 ? ",\n" : "\n") << "      {\"class\": \"" << to_string(fit.complexity) << "\""
+            << std::format(", \"intercept\": {:.6g}, \"coefficient\": {:.6g}", fit.intercept, fit.coefficient)
+            << ", \"exponent\": "
+            << (fit.complexity == ComplexityClass::power_law ? std::format("{:.6g}", fit.exponent) : "null")
+            << std::format(", \"r_squared\": {:.6f}}}", fit.r_squared);
+    }
+    out << "\n    ]\n  }";
+}
+
+inline constexpr size_t report_buffer_size = size_t{1} << 20;
+
+// Appends the shortest text that reads back as `value`, without the per-call cost of stream formatting
+template <typename T>
+requires std::is_arithmetic_v<T>
+void append_number(std::string& out, T value)
+{
+    std::array<char, 32> digits;
+    const auto result = std::to_chars(digits.data(), digits.data() + digits.size(), value);
+    out.append(digits.data(), result.ptr);
+}
+
+// Optional cell of a runtime profile row, written after sample_size. It refers to the profile instead of holding a
+// formatted string, so rows are built without allocating. Empty cells are left blank in CSV, null in JSON, omitted in
+// text
+struct ExtraCell
+{
+    std::string_view name;
+    std::variant<std::monostate, double, std::int64_t, std::uint64_t, std::string_view> value{};
+
+    [[nodiscard]] bool empty() const noexcept { return std::holds_alternative<std::monostate>(value); }
+};
+
+[[nodiscard]] inline ExtraCell metric_cell(std::string_view name, const std::optional<double>& value) noexcept
+{
+    if (!value) return {name};
+    return {name, *value};
+}
+
+// Metrics are written with two decimals. Text cells hold fixed identifiers such as cache modes, quoted in JSON
+inline void append_cell_value(std::string& out, const ExtraCell& cell, bool json)
+{
+    if (const auto* metric = std::get_if<double>(&cell.value))
+    {
+        std::format_to(std::back_inserter(out), "{:.2f}", *metric);
+    }
+    else if (const auto* count = std::get_if<std::uint64_t>(&cell.value)) { append_number(out, *count); }
+    else if (const auto* id = std::get_if<std::int64_t>(&cell.value)) { append_number(out, *id); }
+    else if (const auto* text = std::get_if<std::string_view>(&cell.value))
+    {
+        if (json) { out += '"'; }
+        out += *text;
+        if (json) { out += '"'; }
+    }
+    else if (json) { out += "null"; }
+}
+
+// Calls visit(cell) for each optional column of the sample at `index`, in report order
+template <ChronoDuration Unit, typename Visit>
+void for_each_extra_cell(const RuntimeProfile<Unit>& profile, size_t index, Visit&& visit)
+{
+    const auto count = [](auto value) { return static_cast<std::uint64_t>(value); };
+
+    if (!profile.counters.empty())
+    {
+        const auto& counters = profile.counters[index];
+        for (const auto& field : counter_fields) { visit(metric_cell(field.name, counters.*field.member)); }
+    }
+
+    if (!profile.allocations.empty())
+    {
+        const auto& allocations = profile.allocations[index];
+        visit(metric_cell("allocations", allocations.allocations));
+        visit(metric_cell("bytes_allocated", allocations.bytes_allocated));
+        visit(ExtraCell{"peak_live_bytes", count(allocations.peak_live_bytes)});
+    }
+
+    if (!profile.cpu_ids.empty()) { visit(ExtraCell{"cpu_id", static_cast<std::int64_t>(profile.cpu_ids[index])}); }
+    if (!profile.process_usage.empty())
+    {
+        const auto& usage = profile.process_usage[index];
+        visit(ExtraCell{"max_rss_bytes", count(usage.max_rss_bytes)});
+        visit(ExtraCell{"voluntary_switches", count(usage.voluntary_switches)});
+        visit(ExtraCell{"involuntary_switches", count(usage.involuntary_switches)});
+    }
+    if (!profile.cache_modes.empty()) { visit(ExtraCell{"cache_mode", to_string(profile.cache_modes[index])}); }
+
+    // Rates at the median time of the sample. Bandwidth is left out when the bytes of a call are unknown
+    if (!profile.throughput.empty())
+    {
+        const auto& throughput = profile.throughput[index];
+        const double seconds = std::chrono::duration<double>(profile.raw_durations[index]).count();
+        const auto items = static_cast<double>(throughput.items);
+        const auto bytes = static_cast<double>(throughput.bytes);
+        auto rate = [seconds](double amount) -> std::optional<double> {
+            if (seconds <= 0.0 || amount <= 0.0) return std::nullopt;
+            return amount / seconds;
+        };
+
+        visit(ExtraCell{"items", count(throughput.items)});
+        visit(ExtraCell{"bytes", count(throughput.bytes)});
+        visit(metric_cell("items_per_second", rate(items)));
+        visit(metric_cell("gb_per_second", rate(bytes).transform([](double b) { return b / 1e9; })));
+        visit(metric_cell("ns_per_item", items > 0.0 ? std::optional(seconds * 1e9 / items) : std::nullopt));
+        if (profile.peak_bandwidth && *profile.peak_bandwidth > 0.0)
+        {
+            const auto fraction = rate(bytes).transform([&profile](double b) { return b / *profile.peak_bandwidth; });
+            visit(metric_cell("peak_fraction", fraction));
+        }
+    }
+
+    // Percentiles of samples stored as histograms, in the unit of the profile
+    if (!profile.histograms.empty())
+    {
+        const auto& histogram = profile.histograms[index];
+        const auto in_unit = [](std::string_view name, double nanoseconds) {
+            const std::chrono::duration<double, std::nano> value(nanoseconds);
+            return metric_cell(name, std::chrono::duration_cast<Fractional<Unit>>(value).count());
+        };
+        visit(ExtraCell{"repetitions", count(histogram.count())});
+        visit(in_unit("p50", histogram.percentile(0.50)));
+        visit(in_unit("p90", histogram.percentile(0.90)));
+        visit(in_unit("p99", histogram.percentile(0.99)));
+        visit(in_unit("p999", histogram.percentile(0.999)));
+        visit(in_unit("max", static_cast<double>(histogram.max())));
+    }
+
+    // A fit assigned by hand may cover fewer samples than the profile, their residual is left empty
+    if (profile.complexity)
+    {
+        const auto& residuals = profile.complexity->best_fit().residuals;
+        visit(metric_cell("residual", index < residuals.size() ? std::optional(residuals[index]) : std::nullopt));
+    }
+}
+
+// Report text built in a preallocated string and written to the stream in large blocks
+class ReportBuffer
+{
+public:
+    explicit ReportBuffer(std::ostream& out) : out(&out) { buffer.reserve(report_buffer_size); }
+
+    [[nodiscard]] std::string& text() noexcept { return buffer; }
+    [[nodiscard]] std::ostream& stream() noexcept { return *out; }
+
+    // Called after each row, writes once the buffer is nearly full so it never reallocates
+    void commit()
+    {
+        if (buffer.size() >= report_buffer_size - report_buffer_size / 8) { flush(); }
+    }
+
+    void flush()
+    {
+        out->write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    }
+
+private:
+    std::ostream* out;
+    std::string buffer;
+};
+
+enum class ReportFormat
+{
+    text,
+    csv,
+    json
+};
+
+[[nodiscard]] inline std::optional<ReportFormat> report_format(const std::filesystem::path& extension)
+{
+    if (extension == ".txt") return ReportFormat::text;
+    if (extension == ".csv") return ReportFormat::csv;
+    if (extension == ".json") return ReportFormat::json;
+    return std::nullopt;
+}
+
 template <ChronoDuration Unit>
-void write_text_report_impl(std::ostream& out, const RuntimeProfile<Unit>& profile)
+void append_csv_header(std::string& out, const RuntimeProfile<Unit>& profile)
 {
-    size_t i = 0;
-    for (const auto& [duration, size] : std::views::zip(profile.raw_durations, profile.sample_sizes))
+    out += "sample_id,time_unit,time_value,sample_size";
+    if (!profile.empty())
     {
-        out << "Sample " << ++i << ": "
-            << "| Time: " << duration.count() << " " << profile.unit_symbol << " | Sample size: " << size << "\n";
+        for_each_extra_cell(profile, 0, [&out](const ExtraCell& cell) {
+            out += ',';
+            out += cell.name;
+        });
     }
+    out += '\n';
 }
 
 template <ChronoDuration Unit>
-void write_csv_report_impl(std::ostream& out, const RuntimeProfile<Unit>& profile)
+void append_text_row(std::string& out, const RuntimeProfile<Unit>& profile, size_t index)
+{
+    out += "Sample ";
+    append_number(out, index + 1);
+    out += ": | Time: ";
+    append_number(out, profile.raw_durations[index].count());
+    out += ' ';
+    out += profile.unit_symbol;
+    out += " | Sample size: ";
+    append_number(out, profile.sample_sizes[index]);
+
+    for_each_extra_cell(profile, index, [&out](const ExtraCell& cell) {
+        if (cell.empty()) return;
+        out += " | ";
+        out += cell.name;
+        out += ": ";
+        append_cell_value(out, cell, false);
+    });
+    out += '\n';
+}
+
+template <ChronoDuration Unit>
+void append_csv_row(std::string& out, const RuntimeProfile<Unit>& profile, size_t index, size_t sample_id)
+{
+    append_number(out, sample_id);
+    out += ',';
+    out += profile.unit_symbol;
+    out += ',';
+    append_number(out, profile.raw_durations[index].count());
+    out += ',';
+    append_number(out, profile.sample_sizes[index]);
+    for_each_extra_cell(profile, index, [&out](const ExtraCell& cell) {
+        out += ',';
+        append_cell_value(out, cell, false);
+    });
+    out += '\n';
+}
+
+template <ChronoDuration Unit>
+void append_json_row(std::string& out, const RuntimeProfile<Unit>& profile, size_t index)
+{
+    out += "    {\n      \"sample_id\": ";
+    append_number(out, index + 1);
+    out += ",\n      \"time_unit\": \"";
+    out += profile.unit_symbol;
+    out += "\",\n      \"time_value\": ";
+    append_number(out, profile.raw_durations[index].count());
+    out += ",\n      \"sample_size\": ";
+    append_number(out, profile.sample_sizes[index]);
+
+    for_each_extra_cell(profile, index, [&out](const ExtraCell& cell) {
+        out += ",\n      \"";
+        out += cell.name;
+        out += "\": ";
+        append_cell_value(out, cell, true);
+    });
+    out += "\n    }";
+}
+
+// One sample as a single-line JSON object, the record format of JSON-lines files
+template <ChronoDuration Unit>
+void append_json_line(std::string& out, const RuntimeProfile<Unit>& profile, size_t index, size_t sample_id)
+{
+    out += "{\"sample_id\": ";
+    append_number(out, sample_id);
+    out += ", \"time_unit\": \"";
+    out += profile.unit_symbol;
+    out += "\", \"time_value\": ";
+    append_number(out, profile.raw_durations[index].count());
+    out += ", \"sample_size\": ";
+    append_number(out, profile.sample_sizes[index]);
+    for_each_extra_cell(profile, index, [&out](const ExtraCell& cell) {
+        out += ", \"";
+        out += cell.name;
+        out += "\": ";
+        append_cell_value(out, cell, true);
+    });
+    out += "}\n";
+}
+
+// Writes the profile in every requested format in a single pass over the samples. The optional columns of each
+// sample are formatted straight into the buffer of each format. JSON is always {"samples": [...]}, with a
+// "complexity" key after the samples when the profile holds a fit
+template <ChronoDuration Unit>
+void write_reports(const RuntimeProfile<Unit>& profile, std::span<const std::pair<ReportFormat, std::ostream*>> outputs)
 {
-    out << "sample_id,time_unit,time_value,sample_size\n";
-    size_t i = 0;
-    for (const auto& [duration, size] : std::views::zip(profile.raw_durations, profile.sample_sizes))
+    std::vector<ReportBuffer> buffers;
+    buffers.reserve(outputs.size());
+    for (const auto& [format, out] : outputs)
     {
-        out << ++i << "," << profile.unit_symbol << "," << duration.count() << "," << size << "\n";
+        auto& buffer = buffers.emplace_back(*out);
+        if (format == ReportFormat::csv) { append_csv_header(buffer.text(), profile); }
+        else if (format == ReportFormat::json) { buffer.text() += "{\n  \"samples\": [\n"; }
     }
+
+    for (size_t i = 0; i < profile.size(); ++i)
+    {
+        for (size_t o = 0; o < outputs.size(); ++o)
+        {
+            auto& text = buffers[o].text();
+            switch (outputs[o].first)
+            {
+                case ReportFormat::text: append_text_row(text, profile, i); break;
+                case ReportFormat::csv: append_csv_row(text, profile, i, i + 1); break;
+                case ReportFormat::json:
+                    if (i > 0) { text += ",\n"; }
+                    append_json_row(text, profile, i);
+                    break;
+            }
+            buffers[o].commit();
+        }
+    }
+
+    for (size_t o = 0; o < outputs.size(); ++o)
+    {
+        auto& buffer = buffers[o];
+        if (outputs[o].first == ReportFormat::json) { buffer.text() += "\n  ]"; }
+        buffer.flush();
+
+        // The complexity summary is small, it goes through the stream directly
+        auto& out = buffer.stream();
+        if (outputs[o].first == ReportFormat::text && profile.complexity)
+        {
+            write_text_complexity(out, *profile.complexity);
+        }
+        else if (outputs[o].first == ReportFormat::json)
+        {
+            if (profile.complexity)
+            {
+                out << ",\n";
+                write_json_complexity(out, *profile.complexity);
+            }
+            out << "\n}\n";
+        }
+    }
+}
+
+template <ChronoDuration Unit>
+void write_text_report_impl(std::ostream& out, const RuntimeProfile<Unit>& profile)
+{
+    const std::pair<ReportFormat, std::ostream*> output{ReportFormat::text, &out};
+    write_reports(profile, std::span(&output, 1));
+}
+
+template <ChronoDuration Unit>
+void write_csv_report_impl(std::ostream& out, const RuntimeProfile<Unit>& profile)
+{
+    const std::pair<ReportFormat, std::ostream*> output{ReportFormat::csv, &out};
+    write_reports(profile, std::span(&output, 1));
 }
 
 template <ChronoDuration Unit>
 void write_json_report_impl(std::ostream& out, const RuntimeProfile<Unit>& profile)
 {
-    out << "[\n";
-    bool first = true;
-    size_t i = 0;
+    const std::pair<ReportFormat, std::ostream*> output{ReportFormat::json, &out};
+    write_reports(profile, std::span(&output, 1));
+}
+
+// One event per sample with its repetitions nested inside, on the core that measured it. A recorded timeline places
+// every repetition where it ran; without one, e.g. for loaded profiles, the repetitions of each core are laid out
+// back to back from zero. Samples stored as histograms have no time per repetition, so they are a single event
+template <ChronoDuration Unit>
+void append_trace_events(TraceWriter& trace, int pid, const RuntimeProfile<Unit>& profile)
+{
+    const auto run_count = [&profile](size_t i) {
+        const bool histogram = profile.repetitions[i].empty() && i < profile.histograms.size();
+        return histogram ? static_cast<size_t>(profile.histograms[i].count()) : profile.repetitions[i].size();
+    };
 
-    for (const auto& [duration, size] : std::views::zip(profile.raw_durations, profile.sample_sizes))
+    bool recorded = profile.timeline.size() == profile.size();
+    for (size_t i = 0; recorded && i < profile.size(); ++i)
     {
-        if (!first) { out << ",\n"; }
+        recorded = profile.timeline[i].size() == run_count(i) && !profile.timeline[i].empty();
+    }
+
+    trace.process_name(pid, std::format("Runtime profile ({})", profile.unit_symbol));
+    trace.process_labels(pid, recorded ? "recorded timeline" : "reconstructed timeline");
 
-        out << "  {\n"
-            << "    \"sample_id\": " << ++i << ",\n"
-            << "    \"time_unit\": \"" << profile.unit_symbol << "\",\n"
-            << "    \"time_value\": " << duration.count() << ",\n"
-            << "    \"sample_size\": " << size << "\n"
-            << "  }";
+    std::map<int, double> cursors; // Next free nanosecond of each core in a reconstructed timeline
+    std::vector<std::pair<double, double>> spans;
+    for (size_t i = 0; i < profile.size(); ++i)
+    {
+        const int tid = profile.cpu_ids.empty() ? 0 : profile.cpu_ids[i];
+        if (!cursors.contains(tid))
+        {
+            trace.thread_name(pid, tid, profile.cpu_ids.empty() ? "measurement" : std::format("cpu {}", tid));
+        }
+        auto& cursor = cursors[tid];
 
-        first = false;
+        const auto& runs = profile.repetitions[i];
+        spans.clear();
+        if (recorded)
+        {
+            for (const auto& span : profile.timeline[i])
+            {
+                spans.emplace_back(static_cast<double>(span.start.count()),
+                                   static_cast<double>((span.end - span.start).count()));
+            }
+        }
+        else if (runs.empty() && i < profile.histograms.size())
+        {
+            const auto& histogram = profile.histograms[i];
+            if (!histogram.empty()) { spans.emplace_back(cursor, static_cast<double>(histogram.sum())); }
+            cursor += static_cast<double>(histogram.sum());
+        }
+        else
+        {
+            for (const auto& run : runs)
+            {
+                const double duration_ns = Fractional<std::chrono::nanoseconds>(run).count();
+                spans.emplace_back(cursor, duration_ns);
+                cursor += duration_ns;
+            }
+        }
+        if (spans.empty()) { continue; }
+
+        std::string args =
+            std::format("\"sample_size\": {}, \"median\": {}, \"time_unit\": \"{}\", \"repetitions\": {}",
+                        profile.sample_sizes[i], profile.raw_durations[i].count(), profile.unit_symbol, run_count(i));
+        for_each_extra_cell(profile, i, [&args](const ExtraCell& cell) {
+            if (cell.name == "repetitions") return; // Already set, for samples stored as histograms
+            args += ", \"";
+            args += cell.name;
+            args += "\": ";
+            append_cell_value(args, cell, true);
+        });
+        const double start_ns = spans.front().first;
+        trace.complete(std::format("size {}", profile.sample_sizes[i]), "sample", pid, tid, start_ns,
+                       spans.back().first + spans.back().second - start_ns, args);
+
+        for (size_t r = 0; r < runs.size() && r < spans.size(); ++r)
+        {
+            trace.complete(std::format("repetition {}", r + 1), "repetition", pid, tid, spans[r].first,
+                           spans[r].second,
+                           std::format("\"time\": {}, \"time_unit\": \"{}\"", runs[r].count(), profile.unit_symbol));
+        }
     }
-    out << "\n]\n";
 }
 
-} // namespace detail
+template <ChronoDuration Unit>
+void write_trace_report_impl(std::ostream& out, const RuntimeProfile<Unit>& profile)
+{
+    TraceWriter trace(out);
+    append_trace_events(trace, 1, profile);
+    trace.finish();
+}
 
+// Columns shared by every scaling report format, in order, after threads
 template <ChronoDuration Unit>
-void print_report(const RuntimeProfile<Unit>& runtime_profile)
+[[nodiscard]] std::vector<ExtraColumn> scaling_columns(const ScalingProfile<Unit>& profile, size_t index)
 {
-    detail::write_text_report_impl(std::cout, runtime_profile);
+    const auto& per_thread = profile.thread_throughput[index];
+    const auto [slowest, fastest] = std::ranges::minmax_element(per_thread);
+
+    std::vector<ExtraColumn> columns = {
+        {"operations", std::to_string(profile.operations[index])},
+        {"throughput", format_metric(profile.throughput[index])},
+        {"speedup", std::format("{:.3f}", profile.speedup[index])},
+        {"efficiency", std::format("{:.3f}", profile.efficiency[index])},
+        {"thread_throughput_min", per_thread.empty() ? std::nullopt : format_metric(*slowest)},
+        {"thread_throughput_max", per_thread.empty() ? std::nullopt : format_metric(*fastest)},
+    };
+
+    if (!profile.latencies.empty())
+    {
+        const auto& latency = profile.latencies[index];
+        columns.push_back({"latency_p50", format_metric(latency.p50.count())});
+        columns.push_back({"latency_p99", format_metric(latency.p99.count())});
+        columns.push_back({"latency_p999", format_metric(latency.p999.count())});
+        columns.push_back({"latency_max", format_metric(latency.max.count())});
+    }
+
+    return columns;
 }
 
 template <ChronoDuration Unit>
-void save_report(const RuntimeProfile<Unit>& runtime_profile, const std::filesystem::path& filename)
+void write_text_report_impl(std::ostream& out, const ScalingProfile<Unit>& profile)
 {
-    std::ofstream file(filename);
-    if (!file.is_open()) { throw std::runtime_error("Error: Could not open file " + filename.string()); }
+    for (size_t i = 0; i < profile.size(); ++i)
+    {
+        out << "Threads " << profile.thread_counts[i] << ": "
+            << "| Time: " << profile.elapsed[i].count() << " " << profile.unit_symbol;
+
+        for (const auto& column : scaling_columns(profile, i))
+        {
+            if (column.value) { out << " | " << column.name << ": " << *column.value; }
+        }
+        out << "\n";
+    }
+}
+
+template <ChronoDuration Unit>
+void write_csv_report_impl(std::ostream& out, const ScalingProfile<Unit>& profile)
+{
+    out << "sample_id,time_unit,time_value,threads";
+    if (!profile.empty())
+    {
+        for (const auto& column : scaling_columns(profile, 0)) { out << "," << column.name; }
+    }
+    out << "\n";
 
+    for (size_t i = 0; i < profile.size(); ++i)
+    {
+        out << i + 1 << "," << profile.unit_symbol << "," << profile.elapsed[i].count() << ","
+            << profile.thread_counts[i];
+        for (const auto& column : scaling_columns(profile, i)) { out << "," << column.value.value_or(""); }
+        out << "\n";
+    }
+}
+
+template <ChronoDuration Unit>
+void write_json_report_impl(std::ostream& out, const ScalingProfile<Unit>& profile)
+{
+    out << "{\n  \"samples\": [\n";
+    for (size_t i = 0; i < profile.size(); ++i)
+    {
+        if (i > 0) { out << ",\n"; }
+
+        out << "    {\n"
+            << "      \"sample_id\": " << i + 1 << ",\n"
+            << "      \"time_unit\": \"" << profile.unit_symbol << "\",\n"
+            << "      \"time_value\": " << profile.elapsed[i].count() << ",\n"
+            << "      \"threads\": " << profile.thread_counts[i];
+
+        for (const auto& column : scaling_columns(profile, i))
+        {
+            out << ",\n      \"" << column.name << "\": " << column.value.value_or("null");
+        }
+
+        out << ",\n      \"thread_throughput\": [";
+        const auto& per_thread = profile.thread_throughput[i];
+        for (size_t t = 0; t < per_thread.size(); ++t)
+        {
+            out << (t > 0 ? ", " : "") << std::format("{:.2f}", per_thread[t]);
+        }
+        out << "]\n    }";
+    }
+    out << "\n  ]\n}\n";
+}
+
+} // namespace detail
+
+// Anything with text, CSV and JSON writers: RuntimeProfile, ScalingProfile, RegressionReport and ZoneReport
+template <typename Profile>
+concept ReportableProfile = requires(std::ostream& out, const Profile& profile) {
+    detail::write_text_report_impl(out, profile);
+    detail::write_csv_report_impl(out, profile);
+    detail::write_json_report_impl(out, profile);
+};
+
+// Reports with a timeline for trace files: RuntimeProfile and ZoneReport
+template <typename Report>
+concept TraceableReport = requires(detail::TraceWriter& trace, const Report& report) {
+    detail::append_trace_events(trace, 1, report);
+};
+
+template <ReportableProfile Profile>
+void print_report(const Profile& runtime_profile)
+{
+    detail::write_text_report_impl(std::cout, runtime_profile);
+}
+
+template <ReportableProfile Profile>
+void save_report(const Profile& runtime_profile, const std::filesystem::path& filename)
+{
     const auto ext = filename.extension();
 
+    std::ofstream file(filename, ext == ".srp" ? std::ios::out | std::ios::binary : std::ios::out);
+    if (!file.is_open()) { throw std::runtime_error("Error: Could not open file " + filename.string()); }
+
+    constexpr bool has_binary = requires { detail::write_binary_report_impl(file, runtime_profile); };
+
     if (ext == ".txt") { detail::write_text_report_impl(file, runtime_profile); }
     else if (ext == ".csv") { detail::write_csv_report_impl(file, runtime_profile); }
     else if (ext == ".json") { detail::write_json_report_impl(file, runtime_profile); }
+    else if (ext == ".trace" && TraceableReport<Profile>)
+    {
+        if constexpr (TraceableReport<Profile>) { detail::write_trace_report_impl(file, runtime_profile); }
+    }
+    else if (ext == ".srp" && has_binary)
+    {
+        if constexpr (has_binary) { detail::write_binary_report_impl(file, runtime_profile); }
+    }
     else { throw std::runtime_error("Error: Unsupported file extension " + ext.string()); }
 }
 
-template <ChronoDuration Unit>
-void save_report(const RuntimeProfile<Unit>& runtime_profile, const std::string& base_filename = "runtime_report")
+template <ReportableProfile Profile>
+void save_report(const Profile& runtime_profile, const std::string& base_filename = "runtime_report")
 {
     const auto filename = std::filesystem::path(base_filename).replace_extension(".csv");
     save_report(runtime_profile, filename);
 }
 
-template <ChronoDuration Unit>
-void save_reports(const RuntimeProfile<Unit>& runtime_profile, const std::string& base_filename = "runtime_report")
+// Saves the report once per extension next to base_filename, .csv, .json and .txt by default. Any other extension of
+// save_report, such as .srp, is written on its own. Runtime profiles are serialized in a single pass that writes
+// every text file at once
+template <ReportableProfile Profile>
+void save_reports(const Profile& runtime_profile,
+                  const std::string& base_filename = "runtime_report",
+                  std::initializer_list<std::string_view> extensions = {".csv", ".json", ".txt"})
 {
     std::filesystem::path base_path(base_filename);
 
-    save_report(runtime_profile, base_path.replace_extension(".csv"));
-    save_report(runtime_profile, base_path.replace_extension(".json"));
-    save_report(runtime_profile, base_path.replace_extension(".txt"));
+    if constexpr (requires(std::span<const std::pair<detail::ReportFormat, std::ostream*>> outputs) {
+                      detail::write_reports(runtime_profile, outputs);
+                  })
+    {
+        std::vector<std::ofstream> files;
+        files.reserve(extensions.size()); // Outputs point into this vector, it must not reallocate
+        std::vector<std::pair<detail::ReportFormat, std::ostream*>> outputs;
+
+        for (const auto extension : extensions)
+        {
+            const auto format = detail::report_format(extension);
+            if (!format)
+            {
+                // Binary profiles and traces are written on their own
+                save_report(runtime_profile, base_path.replace_extension(extension));
+                continue;
+            }
+
+            const auto filename = base_path.replace_extension(extension);
+            auto& file = files.emplace_back(filename);
+            if (!file.is_open()) { throw std::runtime_error("Error: Could not open file " + filename.string()); }
+            outputs.emplace_back(*format, &file);
+        }
+
+        detail::write_reports(runtime_profile, outputs);
+    }
+    else
+    {
+        for (const auto extension : extensions)
+        {
+            save_report(runtime_profile, base_path.replace_extension(extension));
+        }
+    }
 }
 
-template <ChronoDuration Unit, typename Stream>
+template <ReportableProfile Profile, typename Stream>
 requires std::derived_from<Stream, std::ostream>
-void generate_report(Stream& stream, const RuntimeProfile<Unit>& runtime_profile, const std::string& format = "text")
+void generate_report(Stream& stream, const Profile& runtime_profile, const std::string& format = "text")
 {
     if (format == "text" || format == "txt") { detail::write_text_report_impl(stream, runtime_profile); }
     else if (format == "csv") { detail::write_csv_report_impl(stream, runtime_profile); }
     else if (format == "json") { detail::write_json_report_impl(stream, runtime_profile); }
+    else if (format == "trace" && TraceableReport<Profile>)
+    {
+        if constexpr (TraceableReport<Profile>) { detail::write_trace_report_impl(stream, runtime_profile); }
+    }
     else { throw std::invalid_argument("Unsupported format: " + format); }
 }
 
+// Writes several reports into one trace, each as its own process, e.g. a profile next to the zones recorded inside
+// the profiled function. Timelines share the trace epoch, so recorded events line up
+template <TraceableReport... Reports>
+requires(sizeof...(Reports) > 0)
+void save_trace(const std::filesystem::path& filename, const Reports&... reports)
+{
+    std::ofstream file(filename);
+    if (!file.is_open()) { throw std::runtime_error("Error: Could not open file " + filename.string()); }
+
+    detail::TraceWriter trace(file);
+    int pid = 0;
+    (detail::append_trace_events(trace, ++pid, reports), ...);
+    trace.finish();
+}
+
 } // namespace sra
\ No newline at end of file
@@ -0,0 +1,391 @@
+/**
+ * @file sample_archive.hpp
+ * * @brief Binary sample archives reloaded through memory mapping
+ *
+ * @project Simple Runtime Analyzer
+ *
+ * @author Diego Osorio (ShineKnightDev)
+ *
+ * @copyright Copyright (c) 2025 Diego Osorio (ShineKnightDev)
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#elif defined(_WIN32)
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    include <windows.h>
+#endif
+
+namespace sra
+{
+
+namespace detail
+{
+
+// Layout: header, element data from byte 64, then sample_count + 1 element offsets (uint64) at offsets_offset.
+// Offsets follow the data so archives are written in one pass, even from single-pass ranges
+struct ArchiveHeader
+{
+    std::array<char, 8> magic{};
+    std::uint32_t version = 0;
+    std::uint32_t byte_order = 0; // Written as 0x01020304 in the writer's byte order
+    std::uint32_t element_kind = 0;
+    std::uint32_t element_size = 0;
+    std::uint64_t sample_count = 0;
+    std::uint64_t data_offset = 0;
+    std::uint64_t data_size = 0; // Bytes
+    std::uint64_t offsets_offset = 0;
+    std::uint64_t checksum = 0; // Of the data followed by the offsets
+};
+
+static_assert(sizeof(ArchiveHeader) == 64 && std::is_trivially_copyable_v<ArchiveHeader>);
+
+inline constexpr std::array<char, 8> archive_magic = {'S', 'R', 'A', 'S', 'M', 'P', 'L', '\0'};
+inline constexpr std::uint32_t archive_version = 1;
+inline constexpr std::uint32_t archive_byte_order = 0x01020304;
+
+enum class ElementKind : std::uint32_t
+{
+    signed_integer = 1,
+    unsigned_integer = 2,
+    floating_point = 3
+};
+
+template <typename T>
+concept ArchiveElement = std::is_arithmetic_v<T> && !std::is_same_v<T, bool>;
+
+template <ArchiveElement T>
+[[nodiscard]] constexpr ElementKind element_kind() noexcept
+{
+    if constexpr (std::is_floating_point_v<T>) { return ElementKind::floating_point; }
+    else if constexpr (std::is_signed_v<T>) { return ElementKind::signed_integer; }
+    else { return ElementKind::unsigned_integer; }
+}
+
+[[nodiscard]] constexpr std::uint64_t align_up(std::uint64_t value, std::uint64_t alignment) noexcept
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// Streaming 64-bit checksum over 8-byte words. Not cryptographic, it only detects truncated or corrupted files
+class ArchiveChecksum
+{
+public:
+    void update(std::span<const std::byte> bytes) noexcept
+    {
+        length += bytes.size();
+
+        if (pending_size > 0)
+        {
+            const size_t take = std::min(bytes.size(), pending.size() - pending_size);
+            std::memcpy(pending.data() + pending_size, bytes.data(), take);
+            pending_size += take;
+            bytes = bytes.subspan(take);
+            if (pending_size < pending.size()) return;
+            mix(load(pending.data()));
+            pending_size = 0;
+        }
+
+        const size_t words = bytes.size() / 8;
+        for (size_t i = 0; i < words; ++i) { mix(load(bytes.data() + i * 8)); }
+
+        const size_t tail = bytes.size() - words * 8;
+        std::memcpy(pending.data(), bytes.data() + words * 8, tail);
+        pending_size = tail;
+    }
+
+    [[nodiscard]] std::uint64_t value() const noexcept
+    {
+        std::uint64_t h = state;
+        if (pending_size > 0)
+        {
+            std::array<std::byte, 8> last{};
+            std::memcpy(last.data(), pending.data(), pending_size);
+            h = step(h, load(last.data()));
+        }
+        h ^= length;
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDull;
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53ull;
+        return h ^ (h >> 33);
+    }
+
+private:
+    static std::uint64_t load(const std::byte* bytes) noexcept
+    {
+        std::uint64_t word;
+        std::memcpy(&word, bytes, sizeof(word));
+        return word;
+    }
+
+    static std::uint64_t step(std::uint64_t h, std::uint64_t word) noexcept
+    {
+        return std::rotl(h ^ (word * 0x9E3779B97F4A7C15ull), 31) * 0xBF58476D1CE4E5B9ull;
+    }
+
+    void mix(std::uint64_t word) noexcept { state = step(state, word); }
+
+    std::uint64_t state = 0x5352415348415348ull;
+    std::uint64_t length = 0;
+    std::array<std::byte, 8> pending{};
+    size_t pending_size = 0;
+};
+
+// Read-only mapping of a whole file, or a heap copy on platforms without memory mapping
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::filesystem::path& filename)
+    {
+        const auto error = std::runtime_error("Error: Could not map file " + filename.string());
+#if defined(__unix__) || defined(__APPLE__)
+        const int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) { throw std::runtime_error("Error: Could not open file " + filename.string()); }
+
+        struct stat info{};
+        if (::fstat(fd, &info) != 0)
+        {
+            ::close(fd);
+            throw error;
+        }
+        length = static_cast<size_t>(info.st_size);
+        if (length > 0)
+        {
+            void* view = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (view == MAP_FAILED)
+            {
+                ::close(fd);
+                throw error;
+            }
+            address = static_cast<const std::byte*>(view);
+        }
+        ::close(fd); // The mapping keeps the file open
+#elif defined(_WIN32)
+        HANDLE file = CreateFileW(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            throw std::runtime_error("Error: Could not open file " + filename.string());
+        }
+
+        LARGE_INTEGER file_size{};
+        if (!GetFileSizeEx(file, &file_size))
+        {
+            CloseHandle(file);
+            throw error;
+        }
+        length = static_cast<size_t>(file_size.QuadPart);
+        if (length > 0)
+        {
+            HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+            if (mapping) { CloseHandle(mapping); }
+            if (!view)
+            {
+                CloseHandle(file);
+                throw error;
+            }
+            address = static_cast<const std::byte*>(view);
+        }
+        CloseHandle(file);
+#else
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open()) { throw std::runtime_error("Error: Could not open file " + filename.string()); }
+        length = static_cast<size_t>(std::filesystem::file_size(filename));
+        copy = std::make_unique<std::byte[]>(length);
+        if (!file.read(reinterpret_cast<char*>(copy.get()), static_cast<std::streamsize>(length))) { throw error; }
+        address = copy.get();
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile()
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        if (address) { ::munmap(const_cast<std::byte*>(address), length); }
+#elif defined(_WIN32)
+        if (address) { UnmapViewOfFile(address); }
+#endif
+    }
+
+    [[nodiscard]] std::span<const std::byte> bytes() const noexcept { return {address, length}; }
+
+private:
+    const std::byte* address = nullptr;
+    size_t length = 0;
+#if !defined(__unix__) && !defined(__APPLE__) && !defined(_WIN32)
+    std::unique_ptr<std::byte[]> copy;
+#endif
+};
+
+} // namespace detail
+
+// Samples of a memory-mapped archive. Each sample is a span into the mapping, valid while the archive is alive
+template <detail::ArchiveElement T>
+class SampleArchive
+{
+public:
+    using value_type = std::span<const T>;
+
+    explicit SampleArchive(const std::filesystem::path& filename, bool verify_checksum = true)
+        : file(std::make_unique<detail::MappedFile>(filename))
+    {
+        const auto bytes = file->bytes();
+        auto invalid = [&filename](const std::string& reason) {
+            return std::runtime_error("Error: " + filename.string() + " is not a valid sample archive (" + reason +
+                                      ")");
+        };
+
+        detail::ArchiveHeader header;
+        if (bytes.size() < sizeof(header)) { throw invalid("truncated header"); }
+        std::memcpy(&header, bytes.data(), sizeof(header));
+
+        if (header.magic != detail::archive_magic) { throw invalid("bad magic"); }
+        if (header.version != detail::archive_version) { throw invalid("unsupported version"); }
+        if (header.byte_order != detail::archive_byte_order) { throw invalid("written with another byte order"); }
+        if (header.element_kind != static_cast<std::uint32_t>(detail::element_kind<T>()) ||
+            header.element_size != sizeof(T))
+        {
+            throw invalid("element type mismatch");
+        }
+
+        const std::uint64_t offsets_size = (header.sample_count + 1) * sizeof(std::uint64_t);
+        if (header.sample_count >= bytes.size() / sizeof(std::uint64_t) || header.data_offset % alignof(T) != 0 ||
+            header.offsets_offset % alignof(std::uint64_t) != 0 || header.data_offset < sizeof(header) ||
+            header.data_size > bytes.size() || header.data_offset > bytes.size() - header.data_size ||
+            header.offsets_offset < header.data_offset + header.data_size ||
+            header.offsets_offset > bytes.size() || offsets_size > bytes.size() - header.offsets_offset)
+        {
+            throw invalid("truncated file");
+        }
+
+        const auto data = bytes.subspan(header.data_offset, header.data_size);
+        const auto offset_bytes = bytes.subspan(header.offsets_offset, offsets_size);
+
+        if (verify_checksum)
+        {
+            detail::ArchiveChecksum checksum;
+            checksum.update(data);
+            checksum.update(offset_bytes);
+            if (checksum.value() != header.checksum) { throw invalid("checksum mismatch"); }
+        }
+
+        const auto* offsets = reinterpret_cast<const std::uint64_t*>(offset_bytes.data());
+        const auto* elements = reinterpret_cast<const T*>(data.data());
+        if (offsets[0] != 0 || offsets[header.sample_count] * sizeof(T) != header.data_size)
+        {
+            throw invalid("inconsistent offsets");
+        }
+
+        samples.reserve(header.sample_count);
+        for (std::uint64_t i = 0; i < header.sample_count; ++i)
+        {
+            if (offsets[i + 1] < offsets[i]) { throw invalid("inconsistent offsets"); }
+            samples.emplace_back(elements + offsets[i], elements + offsets[i + 1]);
+        }
+    }
+
+    [[nodiscard]] auto begin() const noexcept { return samples.begin(); }
+    [[nodiscard]] auto end() const noexcept { return samples.end(); }
+    [[nodiscard]] std::size_t size() const noexcept { return samples.size(); }
+    [[nodiscard]] bool empty() const noexcept { return samples.empty(); }
+    [[nodiscard]] const std::span<const T>& operator[](std::size_t index) const { return samples[index]; }
+
+private:
+    std::unique_ptr<detail::MappedFile> file; // Behind a pointer so moving the archive keeps the spans valid
+    std::vector<std::span<const T>> samples;
+};
+
+// Writes samples of arithmetic elements as a binary archive in a single pass over `samples`, so lazy sample ranges
+// are generated only once. Each sample is written with one large write through a 1 MiB stream buffer
+template <std::ranges::input_range Container>
+requires std::ranges::contiguous_range<std::ranges::range_reference_t<Container>> &&
+         detail::ArchiveElement<std::ranges::range_value_t<std::ranges::range_reference_t<Container>>>
+void save_sample_archive(Container&& samples, const std::filesystem::path& filename)
+{
+    using T = std::ranges::range_value_t<std::ranges::range_reference_t<Container>>;
+
+    std::vector<char> buffer(size_t{1} << 20);
+    std::ofstream file;
+    file.rdbuf()->pubsetbuf(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    file.open(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) { throw std::runtime_error("Error: Could not open file " + filename.string()); }
+
+    auto write_bytes = [&file](std::span<const std::byte> bytes) {
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    };
+
+    detail::ArchiveHeader header;
+    header.magic = detail::archive_magic;
+    header.version = detail::archive_version;
+    header.byte_order = detail::archive_byte_order;
+    header.element_kind = static_cast<std::uint32_t>(detail::element_kind<T>());
+    header.element_size = sizeof(T);
+    header.data_offset = sizeof(header);
+
+    // Placeholder, rewritten once the offsets and checksum are known
+    write_bytes(std::as_bytes(std::span(&header, 1)));
+
+    detail::ArchiveChecksum checksum;
+    std::vector<std::uint64_t> offsets = {0};
+    for (auto&& sample : samples)
+    {
+        const auto bytes = std::as_bytes(std::span<const T>(std::ranges::data(sample), std::ranges::size(sample)));
+        write_bytes(bytes);
+        checksum.update(bytes);
+        offsets.push_back(offsets.back() + std::ranges::size(sample));
+    }
+
+    header.sample_count = offsets.size() - 1;
+    header.data_size = offsets.back() * sizeof(T);
+    header.offsets_offset = detail::align_up(header.data_offset + header.data_size, alignof(std::uint64_t));
+
+    const std::array<std::byte, alignof(std::uint64_t)> padding{};
+    write_bytes(std::span(padding).first(header.offsets_offset - header.data_offset - header.data_size));
+
+    const auto offset_bytes = std::as_bytes(std::span(offsets));
+    write_bytes(offset_bytes);
+    checksum.update(offset_bytes);
+    header.checksum = checksum.value();
+
+    file.seekp(0);
+    write_bytes(std::as_bytes(std::span(&header, 1)));
+    file.close();
+    if (!file) { throw std::runtime_error("Error: Could not write file " + filename.string()); }
+}
+
+template <detail::ArchiveElement T>
+[[nodiscard]] SampleArchive<T> load_sample_archive(const std::filesystem::path& filename, bool verify_checksum = true)
+{
+    return SampleArchive<T>(filename, verify_checksum);
+}
+
+} // namespace sra
@@ -12,18 +12,25 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <format>
 #include <fstream>
 #include <iomanip>
+#include <iterator>
+#include <limits>
+#include <memory>
 #include <ostream>
 #include <ranges>
 #include <set>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -171,6 +178,361 @@ template <typename T, detail::FillerFunction<T> F>
     return result;
 }
 
+// Samples generated one at a time when iteration reaches them. The range owns a single buffer, so at most one sample
+// is alive. It is a single-pass range: dereferencing any iterator yields the sample of the most recent position
+template <typename T, detail::FillerFunction<T> F>
+class LazySamples
+{
+public:
+    class iterator
+    {
+    public:
+        using value_type = std::vector<T>;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        iterator(const LazySamples* owner, size_t index) noexcept : owner(owner), index(index) {}
+
+        const value_type& operator*() const { return owner->sample_at(index); }
+
+        iterator& operator++() noexcept
+        {
+            ++index;
+            return *this;
+        }
+
+        void operator++(int) noexcept { ++index; }
+
+        // A default-constructed iterator belongs to no range and compares equal to the end
+        friend bool operator==(const iterator& it, std::default_sentinel_t) noexcept
+        {
+            return it.owner == nullptr || it.index >= it.owner->size();
+        }
+
+    private:
+        const LazySamples* owner = nullptr;
+        size_t index = 0;
+    };
+
+    LazySamples(F filler, std::vector<size_t> sizes, bool reuse_buffer = true)
+        : filler(std::move(filler))
+        , sizes(std::move(sizes))
+        , reuse_buffer(reuse_buffer)
+    {
+    }
+
+    [[nodiscard]] iterator begin() const noexcept { return iterator(this, 0); }
+    [[nodiscard]] std::default_sentinel_t end() const noexcept { return std::default_sentinel; }
+    [[nodiscard]] size_t size() const noexcept { return sizes.size(); }
+    [[nodiscard]] bool empty() const noexcept { return sizes.empty(); }
+
+private:
+    const std::vector<T>& sample_at(size_t index) const
+    {
+        if (generated != index)
+        {
+            // The previous sample is released (or cleared, keeping its capacity) before the next one is filled
+            if (reuse_buffer) { buffer.clear(); }
+            else { std::vector<T>().swap(buffer); }
+
+            generated = sizes.size();
+            filler(buffer, sizes[index]);
+            generated = index;
+        }
+        return buffer;
+    }
+
+    mutable F filler;
+    std::vector<size_t> sizes;
+    bool reuse_buffer = true;
+    mutable std::vector<T> buffer;
+    mutable size_t generated = static_cast<size_t>(-1);
+};
+
+// Lazy counterpart of generate_samples for profile_runtime, peak memory is one sample instead of all of them
+template <typename T, detail::FillerFunction<T> F>
+[[nodiscard]] LazySamples<T, std::decay_t<F>>
+generate_samples_lazy(F&& filler, std::vector<size_t> sizes, bool reuse_buffer = true)
+{
+    return LazySamples<T, std::decay_t<F>>(std::forward<F>(filler), std::move(sizes), reuse_buffer);
+}
+
+enum class Distribution
+{
+    uniform,
+    normal,
+    zipf,
+    sorted,
+    reverse_sorted,
+    nearly_sorted,
+    many_duplicates
+};
+
+struct DistributionConfig
+{
+    Distribution kind = Distribution::uniform;
+    double min = 0.0; // Value range of every distribution except normal
+    double max = 10000.0;
+    double mean = 0.0; // normal
+    double stddev = 1.0;
+    double zipf_exponent = 1.0;  // zipf: rank k in [1, max - min + 1] has weight 1 / k^exponent, value min + k - 1
+    double disorder = 0.01;      // nearly_sorted: fraction of elements replaced by a random value
+    size_t distinct_values = 16; // many_duplicates: evenly spaced values in [min, max]
+
+    std::uint64_t seed = 0x5EED; // The same seed and size always give the same sample
+    size_t threads = 0;          // Threads filling each sample, 0 uses every hardware thread
+};
+
+namespace detail
+{
+
+using PhiloxBlock = std::array<std::uint32_t, 4>;
+
+// Philox4x32-10 counter-based generator (Salmon et al., SC'11). Each (counter, key) pair maps to an independent
+// block of 128 random bits, so any element can be generated without the ones before it
+[[nodiscard]] inline PhiloxBlock philox4x32(PhiloxBlock counter, std::uint64_t seed) noexcept
+{
+    constexpr std::uint32_t multiplier_0 = 0xD2511F53;
+    constexpr std::uint32_t multiplier_1 = 0xCD9E8D57;
+    constexpr std::uint32_t weyl_0 = 0x9E3779B9;
+    constexpr std::uint32_t weyl_1 = 0xBB67AE85;
+
+    std::uint32_t key_0 = static_cast<std::uint32_t>(seed);
+    std::uint32_t key_1 = static_cast<std::uint32_t>(seed >> 32);
+    for (int round = 0; round < 10; ++round)
+    {
+        const std::uint64_t product_0 = std::uint64_t{multiplier_0} * counter[0];
+        const std::uint64_t product_1 = std::uint64_t{multiplier_1} * counter[2];
+        counter = {static_cast<std::uint32_t>(product_1 >> 32) ^ counter[1] ^ key_0,
+                   static_cast<std::uint32_t>(product_1),
+                   static_cast<std::uint32_t>(product_0 >> 32) ^ counter[3] ^ key_1,
+                   static_cast<std::uint32_t>(product_0)};
+        key_0 += weyl_0;
+        key_1 += weyl_1;
+    }
+    return counter;
+}
+
+// Random bits of element `index` of the sample identified by `stream`. `attempt` separates rejection retries
+[[nodiscard]] inline PhiloxBlock
+element_bits(std::uint64_t seed, std::uint64_t stream, std::uint64_t index, std::uint32_t attempt = 0) noexcept
+{
+    return philox4x32({static_cast<std::uint32_t>(index), static_cast<std::uint32_t>(index >> 32),
+                       static_cast<std::uint32_t>(stream ^ (stream >> 32)), attempt},
+                      seed);
+}
+
+[[nodiscard]] inline std::uint64_t bits_64(std::uint32_t high, std::uint32_t low) noexcept
+{
+    return (std::uint64_t{high} << 32) | low;
+}
+
+// Uniform double in [0, 1) with 53 random bits
+[[nodiscard]] inline double unit_double(std::uint64_t bits) noexcept
+{
+    return static_cast<double>(bits >> 11) * 0x1.0p-53;
+}
+
+template <typename T>
+[[nodiscard]] T to_value(double value) noexcept
+{
+    if constexpr (std::is_integral_v<T>)
+    {
+        const double clamped = std::clamp(std::floor(value), static_cast<double>(std::numeric_limits<T>::lowest()),
+                                          static_cast<double>(std::numeric_limits<T>::max()));
+        return static_cast<T>(clamped);
+    }
+    else { return static_cast<T>(value); }
+}
+
+// Zipf sampling by rejection-inversion (Hörmann and Derflinger, 1996), exact for any exponent > 0
+class ZipfSampler
+{
+public:
+    ZipfSampler() = default;
+
+    ZipfSampler(double ranks, double exponent) noexcept : ranks(ranks), exponent(exponent)
+    {
+        h_integral_x1 = h_integral(1.5) - 1.0;
+        h_integral_n = h_integral(ranks + 0.5);
+        threshold = 2.0 - h_integral_inverse(h_integral(2.5) - h(2.0));
+    }
+
+    // Rank in [1, ranks], drawing uniforms until one is accepted
+    template <typename Uniform>
+    [[nodiscard]] double sample(Uniform&& next_uniform) const noexcept
+    {
+        while (true)
+        {
+            const double u = h_integral_n + next_uniform() * (h_integral_x1 - h_integral_n);
+            const double x = h_integral_inverse(u);
+            const double k = std::clamp(std::floor(x + 0.5), 1.0, ranks);
+            if (k - x <= threshold || u >= h_integral(k + 0.5) - h(k)) return k;
+        }
+    }
+
+private:
+    [[nodiscard]] double h(double x) const noexcept { return std::exp(-exponent * std::log(x)); }
+
+    [[nodiscard]] double h_integral(double x) const noexcept
+    {
+        const double log_x = std::log(x);
+        return expm1_over_x((1.0 - exponent) * log_x) * log_x;
+    }
+
+    [[nodiscard]] double h_integral_inverse(double x) const noexcept
+    {
+        const double t = std::max(x * (1.0 - exponent), -1.0);
+        return std::exp(log1p_over_x(t) * x);
+    }
+
+    static double log1p_over_x(double x) noexcept
+    {
+        if (std::abs(x) > 1e-8) return std::log1p(x) / x;
+        return 1.0 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+    }
+
+    static double expm1_over_x(double x) noexcept
+    {
+        if (std::abs(x) > 1e-8) return std::expm1(x) / x;
+        return 1.0 + x * 0.5 * (1.0 + x * (1.0 / 3.0) * (1.0 + 0.25 * x));
+    }
+
+    double ranks = 1.0;
+    double exponent = 1.0;
+    double h_integral_x1 = 0.0;
+    double h_integral_n = 0.0;
+    double threshold = 0.0;
+};
+
+} // namespace detail
+
+// Filler for generate_samples and generate_samples_lazy. Element i of a sample only depends on the seed, the sample
+// size and i, so samples are rebuilt bit-for-bit no matter how many threads fill them
+template <typename T>
+requires std::is_arithmetic_v<T> && (!std::is_same_v<T, bool>)
+class SampleFiller
+{
+public:
+    explicit SampleFiller(const DistributionConfig& config = {}) : config(config)
+    {
+        if (config.max < config.min) { throw std::invalid_argument("Distribution max is lower than min"); }
+        if (config.stddev < 0.0) { throw std::invalid_argument("Distribution stddev must not be negative"); }
+        if (config.zipf_exponent <= 0.0) { throw std::invalid_argument("Distribution zipf_exponent must be positive"); }
+        if (config.disorder < 0.0 || config.disorder > 1.0)
+        {
+            throw std::invalid_argument("Distribution disorder must be within [0, 1]");
+        }
+        if (config.distinct_values == 0) { throw std::invalid_argument("Distribution needs at least one value"); }
+
+        if (config.kind == Distribution::zipf)
+        {
+            zipf = detail::ZipfSampler(std::floor(config.max - config.min) + 1.0, config.zipf_exponent);
+        }
+    }
+
+    void operator()(std::vector<T>& sample, size_t size) const
+    {
+        sample.resize(size);
+
+        constexpr size_t min_chunk = size_t{1} << 15;
+        const size_t hardware = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+        const size_t threads = std::clamp<size_t>(size / min_chunk, 1, config.threads != 0 ? config.threads : hardware);
+
+        if (threads == 1)
+        {
+            fill_range(sample, 0, size);
+            return;
+        }
+
+        std::vector<std::jthread> pool;
+        pool.reserve(threads - 1);
+        const size_t chunk = (size + threads - 1) / threads;
+        for (size_t begin = chunk; begin < size; begin += chunk)
+        {
+            pool.emplace_back([this, &sample, begin, end = std::min(begin + chunk, size)]() {
+                fill_range(sample, begin, end);
+            });
+        }
+        fill_range(sample, 0, std::min(chunk, size));
+    }
+
+private:
+    void fill_range(std::vector<T>& sample, size_t begin, size_t end) const noexcept
+    {
+        const size_t size = sample.size();
+        for (size_t i = begin; i < end; ++i) { sample[i] = value_at(size, i); }
+    }
+
+    [[nodiscard]] T uniform_value(std::uint64_t bits) const noexcept
+    {
+        if constexpr (std::is_integral_v<T>)
+        {
+            const auto low = static_cast<std::int64_t>(std::ceil(config.min));
+            const auto high = static_cast<std::int64_t>(std::floor(config.max));
+            const auto range = static_cast<std::uint64_t>(high - low) + 1;
+            return static_cast<T>(low + static_cast<std::int64_t>(range == 0 ? bits : bits % range));
+        }
+        else { return static_cast<T>(config.min + detail::unit_double(bits) * (config.max - config.min)); }
+    }
+
+    // Evenly spaced from min to max over the sample
+    [[nodiscard]] double ramp(size_t size, size_t i) const noexcept
+    {
+        if (size < 2) return config.min;
+        return config.min + (config.max - config.min) * static_cast<double>(i) / static_cast<double>(size - 1);
+    }
+
+    [[nodiscard]] T value_at(size_t size, size_t i) const noexcept
+    {
+        const auto bits = detail::element_bits(config.seed, size, i);
+        const auto first = detail::bits_64(bits[0], bits[1]);
+        const auto second = detail::bits_64(bits[2], bits[3]);
+
+        switch (config.kind)
+        {
+            case Distribution::uniform: return uniform_value(first);
+            case Distribution::normal:
+            {
+                // Box-Muller, the first uniform is shifted to (0, 1] so its logarithm is finite
+                constexpr double two_pi = 6.283185307179586;
+                const double radius = std::sqrt(-2.0 * std::log(1.0 - detail::unit_double(first)));
+                return detail::to_value<T>(config.mean + config.stddev * radius *
+                                           std::cos(two_pi * detail::unit_double(second)));
+            }
+            case Distribution::zipf:
+            {
+                // Rejected draws continue with the next attempt counter of the same element
+                std::uint32_t attempt = 0;
+                const double rank = zipf.sample([&]() {
+                    const auto draw = attempt == 0 ? bits : detail::element_bits(config.seed, size, i, attempt);
+                    ++attempt;
+                    return detail::unit_double(detail::bits_64(draw[0], draw[1]));
+                });
+                return detail::to_value<T>(config.min + rank - 1.0);
+            }
+            case Distribution::sorted: return detail::to_value<T>(ramp(size, i));
+            case Distribution::reverse_sorted: return detail::to_value<T>(ramp(size, size - 1 - i));
+            case Distribution::nearly_sorted:
+            {
+                if (detail::unit_double(second) < config.disorder) return uniform_value(first);
+                return detail::to_value<T>(ramp(size, i));
+            }
+            case Distribution::many_duplicates:
+            {
+                const size_t level = static_cast<size_t>(first % config.distinct_values);
+                if (config.distinct_values == 1) return detail::to_value<T>(config.min);
+                const double step = (config.max - config.min) / static_cast<double>(config.distinct_values - 1);
+                return detail::to_value<T>(config.min + step * static_cast<double>(level));
+            }
+        }
+        return T{};
+    }
+
+    DistributionConfig config;
+    detail::ZipfSampler zipf;
+};
+
 template <std::ranges::range Iterable>
 requires detail::StreamInsertable<std::ranges::range_value_t<Iterable>>
 [[nodiscard]] std::string serialize_iterable(const Iterable& container)
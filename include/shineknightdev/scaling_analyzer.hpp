@@ -0,0 +1,304 @@
+/**
+ * @file scaling_analyzer.hpp
+ * * @brief Thread-scaling benchmarks for concurrent code
+ *
+ * @project Simple Runtime Analyzer
+ *
+ * @author Diego Osorio (ShineKnightDev)
+ *
+ * @copyright Copyright (c) 2025 Diego Osorio (ShineKnightDev)
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <latch>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "shineknightdev/parallel_profiler.hpp"
+#include "shineknightdev/runtime_analyzer.hpp"
+
+namespace sra
+{
+
+struct ScalingConfig
+{
+    std::vector<size_t> thread_counts = {1, 2, 4, 8}; // A T=1 baseline is added when missing
+    size_t operations_per_thread = 10000;
+    size_t warmup_operations = 0; // Per thread, run before the start barrier
+    size_t trials = 1;            // Runs per thread count, the one with the median wall time is kept
+
+    // Time every operation for the latency percentiles, in a second pass after the throughput pass, so each thread
+    // runs operations_per_thread twice. Disable when the operations cannot be repeated or the second pass is too long
+    bool record_latency = true;
+
+    bool pin_threads = true;
+    std::vector<int> cpus{}; // Cores to pin threads to, empty uses the cores the process is allowed to run on
+};
+
+// Per-operation latency over all threads of one thread count
+template <ChronoDuration Unit>
+struct LatencySummary
+{
+    Fractional<Unit> p50{};
+    Fractional<Unit> p99{};
+    Fractional<Unit> p999{};
+    Fractional<Unit> max{};
+};
+
+template <ChronoDuration Unit>
+struct ScalingProfile
+{
+    std::vector<size_t> thread_counts;
+    std::vector<size_t> operations;                     // Operations completed by all threads together
+    std::vector<Unit> elapsed;                          // From the barrier release until the last thread finished
+    std::vector<double> throughput;                     // Aggregate operations per second
+    std::vector<std::vector<double>> thread_throughput; // Operations per second of each thread
+    std::vector<double> speedup;                        // Throughput relative to T=1
+    std::vector<double> efficiency;                     // Speedup divided by the thread count
+    std::vector<LatencySummary<Unit>> latencies;        // Empty when latency was not recorded
+    std::string unit_symbol;
+
+    ScalingProfile() : unit_symbol(get_unit_symbol<Unit>()) {}
+
+    [[nodiscard]] std::size_t size() const noexcept { return thread_counts.size(); }
+    [[nodiscard]] bool empty() const noexcept { return thread_counts.empty(); }
+};
+
+namespace detail
+{
+
+// Measurements of one thread during one trial
+template <ClockPolicy Clock>
+struct ScalingThreadResult
+{
+    typename Clock::ticks start{};
+    typename Clock::ticks end{};
+    std::vector<double> latencies_ns;
+};
+
+template <ClockPolicy Clock>
+struct ScalingTrial
+{
+    double elapsed_ns = 0.0;
+    std::vector<ScalingThreadResult<Clock>> threads;
+};
+
+// Runs `operation` on `thread_count` threads released together by a start barrier
+template <ClockPolicy Clock, typename Operation>
+[[nodiscard]] ScalingTrial<Clock>
+run_scaling_trial(const ScalingConfig& config, const std::vector<int>& cpus, size_t thread_count, Operation& operation)
+{
+    const auto overhead_ns = timer_overhead<Clock>().count();
+
+    ScalingTrial<Clock> trial;
+    trial.threads.resize(thread_count);
+
+    // The latency pass has a barrier of its own, so its clock reads stay out of the throughput pass
+    std::latch start_barrier(static_cast<std::ptrdiff_t>(thread_count));
+    std::latch latency_barrier(static_cast<std::ptrdiff_t>(thread_count));
+    std::exception_ptr failure;
+    std::mutex failure_mutex;
+    std::atomic<bool> aborted = false;
+    std::atomic<size_t> pin_failures = 0;
+
+    auto record_failure = [&]() {
+        std::scoped_lock lock(failure_mutex);
+        if (!failure) { failure = std::current_exception(); }
+        aborted = true;
+    };
+
+    auto thread_main = [&](size_t thread_index) {
+        auto& result = trial.threads[thread_index];
+        try
+        {
+            if (config.pin_threads && !pin_current_thread(cpus[thread_index % cpus.size()])) { ++pin_failures; }
+            if (config.record_latency) { result.latencies_ns.reserve(config.operations_per_thread); }
+            for (size_t i = 0; i < config.warmup_operations; ++i) { operation(thread_index); }
+        }
+        catch (...)
+        {
+            record_failure();
+        }
+
+        // Every thread arrives at every barrier, even after a failure, so the others are never left waiting
+        start_barrier.arrive_and_wait();
+        if (!aborted)
+        {
+            try
+            {
+                result.start = Clock::start();
+                for (size_t i = 0; i < config.operations_per_thread; ++i) { operation(thread_index); }
+                result.end = Clock::stop();
+            }
+            catch (...)
+            {
+                record_failure();
+            }
+        }
+
+        if (!config.record_latency) return;
+        latency_barrier.arrive_and_wait();
+        if (aborted) return;
+        try
+        {
+            for (size_t i = 0; i < config.operations_per_thread; ++i)
+            {
+                const auto op_start = Clock::start();
+                operation(thread_index);
+                const auto op_end = Clock::stop();
+                result.latencies_ns.push_back(
+                    std::max(static_cast<double>(Clock::to_nanoseconds(op_end - op_start)) - overhead_ns, 0.0));
+            }
+        }
+        catch (...)
+        {
+            record_failure();
+        }
+    };
+
+    {
+        std::vector<std::jthread> pool;
+        pool.reserve(thread_count);
+        for (size_t thread_index = 0; thread_index < thread_count; ++thread_index)
+        {
+            try
+            {
+                pool.emplace_back(thread_main, thread_index);
+            }
+            catch (...)
+            {
+                // Arrives for the threads that could not be created, so the started ones leave the barriers and join
+                record_failure();
+                const auto missing = static_cast<std::ptrdiff_t>(thread_count - thread_index);
+                start_barrier.count_down(missing);
+                if (config.record_latency) { latency_barrier.count_down(missing); }
+                break;
+            }
+        }
+    }
+
+    if (failure) { std::rethrow_exception(failure); }
+    if (pin_failures > 0) { std::cerr << "Warning: " << pin_failures << " thread(s) could not be pinned to a core\n"; }
+
+    auto first_start = trial.threads.front().start;
+    auto last_end = trial.threads.front().end;
+    for (const auto& thread : trial.threads)
+    {
+        first_start = std::min(first_start, thread.start);
+        last_end = std::max(last_end, thread.end);
+    }
+    trial.elapsed_ns = std::max(static_cast<double>(Clock::to_nanoseconds(last_end - first_start)) - overhead_ns, 0.0);
+    return trial;
+}
+
+template <ChronoDuration Unit>
+[[nodiscard]] LatencySummary<Unit> summarize_latencies(std::vector<double>& latencies_ns)
+{
+    LatencySummary<Unit> summary;
+    if (latencies_ns.empty()) return summary;
+
+    std::ranges::sort(latencies_ns);
+    auto to_unit = [](double nanoseconds) {
+        return std::chrono::duration_cast<Fractional<Unit>>(std::chrono::duration<double, std::nano>(nanoseconds));
+    };
+    summary.p50 = to_unit(percentile_sorted(latencies_ns, 0.50));
+    summary.p99 = to_unit(percentile_sorted(latencies_ns, 0.99));
+    summary.p999 = to_unit(percentile_sorted(latencies_ns, 0.999));
+    summary.max = to_unit(latencies_ns.back());
+    return summary;
+}
+
+inline double operations_per_second(size_t operations, double elapsed_ns) noexcept
+{
+    return elapsed_ns > 0.0 ? static_cast<double>(operations) * 1e9 / elapsed_ns : 0.0;
+}
+
+} // namespace detail
+
+template <ChronoDuration Unit = std::chrono::nanoseconds,
+          ClockPolicy Clock = SteadyClock,
+          typename Func,
+          typename... Args>
+requires std::invocable<Func&, size_t, Args&...>
+[[nodiscard]] auto profile_scaling(const ScalingConfig& config, Func&& func, Args&&... args)
+{
+    if (config.thread_counts.empty()) { throw std::invalid_argument("Cannot profile scaling without thread counts"); }
+    if (std::ranges::find(config.thread_counts, size_t{0}) != config.thread_counts.end())
+    {
+        throw std::invalid_argument("Scaling thread counts must be positive");
+    }
+    if (config.operations_per_thread == 0 || config.trials == 0)
+    {
+        throw std::invalid_argument("Scaling config requires at least one operation and one trial");
+    }
+
+    std::vector<size_t> thread_counts = config.thread_counts;
+    if (std::ranges::find(thread_counts, size_t{1}) == thread_counts.end()) { thread_counts.push_back(1); }
+    std::ranges::sort(thread_counts);
+    const auto duplicates = std::ranges::unique(thread_counts);
+    thread_counts.erase(duplicates.begin(), duplicates.end());
+
+    const std::vector<int> cpus = config.cpus.empty() ? detail::available_cpus() : config.cpus;
+
+    // Arguments are shared by every thread, they are the state under contention
+    auto operation = [&func, &args...](size_t thread_index) {
+        detail::invoke_and_keep(func, thread_index, args...);
+    };
+
+    ScalingProfile<Unit> profile;
+    double baseline_throughput = 0.0;
+
+    for (const size_t thread_count : thread_counts)
+    {
+        std::vector<detail::ScalingTrial<Clock>> trials;
+        trials.reserve(config.trials);
+        for (size_t i = 0; i < config.trials; ++i)
+        {
+            trials.push_back(detail::run_scaling_trial<Clock>(config, cpus, thread_count, operation));
+        }
+        std::ranges::sort(trials, {}, &detail::ScalingTrial<Clock>::elapsed_ns);
+        auto& trial = trials[trials.size() / 2];
+
+        const size_t operations = thread_count * config.operations_per_thread;
+        const double throughput = detail::operations_per_second(operations, trial.elapsed_ns);
+        if (thread_count == 1) { baseline_throughput = throughput; }
+
+        std::vector<double> per_thread;
+        per_thread.reserve(thread_count);
+        std::vector<double> latencies_ns;
+        if (config.record_latency) { latencies_ns.reserve(operations); }
+        for (const auto& thread : trial.threads)
+        {
+            const double thread_ns = static_cast<double>(Clock::to_nanoseconds(thread.end - thread.start));
+            per_thread.push_back(detail::operations_per_second(config.operations_per_thread, thread_ns));
+            latencies_ns.insert(latencies_ns.end(), thread.latencies_ns.begin(), thread.latencies_ns.end());
+        }
+
+        const double speedup = baseline_throughput > 0.0 ? throughput / baseline_throughput : 0.0;
+
+        profile.thread_counts.push_back(thread_count);
+        profile.operations.push_back(operations);
+        profile.elapsed.push_back(detail::from_nanoseconds<Unit>(trial.elapsed_ns));
+        profile.throughput.push_back(throughput);
+        profile.thread_throughput.push_back(std::move(per_thread));
+        profile.speedup.push_back(speedup);
+        profile.efficiency.push_back(speedup / static_cast<double>(thread_count));
+        if (config.record_latency) { profile.latencies.push_back(detail::summarize_latencies<Unit>(latencies_ns)); }
+    }
+
+    return profile;
+}
+
+} // namespace sra
@@ -0,0 +1,210 @@
+/**
+ * @file streaming_reporter.hpp
+ * * @brief Incremental report writers fed while profiling runs
+ *
+ * @project Simple Runtime Analyzer
+ *
+ * @author Diego Osorio (ShineKnightDev)
+ *
+ * @copyright Copyright (c) 2025 Diego Osorio (ShineKnightDev)
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "shineknightdev/runtime_analyzer.hpp"
+#include "shineknightdev/runtime_reporter.hpp"
+
+namespace sra
+{
+
+struct StreamingConfig
+{
+    bool resume = false;    // Keep the rows of an existing file and skip their sample sizes
+    size_t flush_every = 1; // Flush after this many samples, 0 only flushes on flush_interval and close
+    std::chrono::nanoseconds flush_interval = std::chrono::nanoseconds::zero(); // Also flush when this much time passed
+};
+
+namespace detail
+{
+
+[[nodiscard]] inline std::optional<size_t> parse_size(std::string_view text)
+{
+    size_t value = 0;
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (error != std::errc{} || end == text.data()) return std::nullopt;
+    return value;
+}
+
+// Field `index` of a CSV line, fields never contain commas in reports
+[[nodiscard]] inline std::string_view csv_field(std::string_view line, size_t index)
+{
+    for (size_t i = 0; i < index; ++i)
+    {
+        const auto comma = line.find(',');
+        if (comma == std::string_view::npos) return {};
+        line.remove_prefix(comma + 1);
+    }
+    return line.substr(0, line.find(','));
+}
+
+// Text after `"key": ` in a JSON-lines record, up to the next separator
+[[nodiscard]] inline std::string_view json_field(std::string_view line, std::string_view key)
+{
+    const std::string pattern = "\"" + std::string(key) + "\": ";
+    const auto start = line.find(pattern);
+    if (start == std::string_view::npos) return {};
+    line.remove_prefix(start + pattern.size());
+    if (line.starts_with('"'))
+    {
+        line.remove_prefix(1);
+        return line.substr(0, line.find('"'));
+    }
+    return line.substr(0, line.find_first_of(",}"));
+}
+
+} // namespace detail
+
+// MeasurementSink writing one CSV row (.csv) or JSON-lines record (.jsonl) per sample as soon as it is measured.
+// Rows match the ones save_report writes, and nothing is kept in memory besides the sizes of resumed rows
+template <ChronoDuration Unit>
+class ReportSink
+{
+public:
+    explicit ReportSink(const std::filesystem::path& filename, const StreamingConfig& config = {})
+        : filename(filename), config(config), last_flush(std::chrono::steady_clock::now())
+    {
+        const auto ext = filename.extension();
+        if (ext == ".csv") { json_lines = false; }
+        else if (ext == ".jsonl") { json_lines = true; }
+        else { throw std::runtime_error("Error: Unsupported file extension " + ext.string()); }
+
+        if (config.resume && std::filesystem::exists(filename)) { load_existing(); }
+
+        file.open(filename, config.resume ? std::ios::app : std::ios::trunc);
+        if (!file.is_open()) { throw std::runtime_error("Error: Could not open file " + filename.string()); }
+    }
+
+    [[nodiscard]] bool completed(size_t sample_size) const { return completed_sizes.contains(sample_size); }
+
+    // Samples written so far, including resumed ones
+    [[nodiscard]] size_t size() const noexcept { return next_id - 1; }
+
+    void push(SampleMeasurement<Unit>&& measurement)
+    {
+        RuntimeProfile<Unit> row;
+        row.append(std::move(measurement));
+
+        // Each record is formatted first and written at once, so a crash leaves at most one partial line
+        std::string record;
+        if (json_lines) { detail::append_json_line(record, row, 0, next_id); }
+        else
+        {
+            std::string header;
+            detail::append_csv_header(header, row);
+            if (existing_header.empty()) { record = header; }
+            else if (existing_header != header)
+            {
+                throw std::runtime_error("Error: Columns of " + filename.string() + " differ from the new samples");
+            }
+            existing_header = std::move(header);
+            detail::append_csv_row(record, row, 0, next_id);
+        }
+
+        file.write(record.data(), static_cast<std::streamsize>(record.size()));
+        if (!file) { throw std::runtime_error("Error: Could not write file " + filename.string()); }
+        ++next_id;
+        ++unflushed;
+
+        const bool count_due = config.flush_every != 0 && unflushed >= config.flush_every;
+        const bool time_due = config.flush_interval > std::chrono::nanoseconds::zero() &&
+                              std::chrono::steady_clock::now() - last_flush >= config.flush_interval;
+        if (count_due || time_due) { flush(); }
+    }
+
+    void flush()
+    {
+        file.flush();
+        unflushed = 0;
+        last_flush = std::chrono::steady_clock::now();
+    }
+
+private:
+    // Reads the rows of an earlier run. A trailing partial line, left by a crash during a write, is cut off
+    void load_existing()
+    {
+        std::string content;
+        {
+            std::ifstream in(filename, std::ios::binary);
+            if (!in.is_open()) { throw std::runtime_error("Error: Could not open file " + filename.string()); }
+            content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+
+        const size_t complete = content.rfind('\n') == std::string::npos ? 0 : content.rfind('\n') + 1;
+        if (complete < content.size())
+        {
+            content.resize(complete);
+            std::filesystem::resize_file(filename, complete);
+        }
+
+        std::string_view lines = content;
+        size_t size_column = 3;
+        bool first = true;
+        while (!lines.empty())
+        {
+            const auto end = lines.find('\n');
+            const auto line = lines.substr(0, end);
+            lines.remove_prefix(end + 1);
+
+            if (!json_lines && first)
+            {
+                // The header names the columns, and new rows must match it
+                existing_header = std::string(line) + "\n";
+                for (size_t i = 0; !detail::csv_field(line, i).empty(); ++i)
+                {
+                    if (detail::csv_field(line, i) == "sample_size") { size_column = i; }
+                }
+                first = false;
+                continue;
+            }
+            if (line.empty()) { continue; }
+
+            const auto unit = json_lines ? detail::json_field(line, "time_unit") : detail::csv_field(line, 1);
+            const auto size = detail::parse_size(json_lines ? detail::json_field(line, "sample_size")
+                                                            : detail::csv_field(line, size_column));
+            if (unit != get_unit_symbol<Unit>() || !size)
+            {
+                throw std::runtime_error("Error: Cannot resume " + filename.string() +
+                                         ", it holds rows of another unit or format");
+            }
+
+            completed_sizes.insert(*size);
+            ++next_id;
+        }
+    }
+
+    std::filesystem::path filename;
+    StreamingConfig config;
+    bool json_lines = false;
+    std::ofstream file;
+    std::string existing_header; // CSV header already in the file
+    std::set<size_t> completed_sizes;
+    size_t next_id = 1;
+    size_t unflushed = 0;
+    std::chrono::steady_clock::time_point last_flush;
+};
+
+} // namespace sra
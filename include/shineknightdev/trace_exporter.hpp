@@ -0,0 +1,88 @@
+/**
+ * @file trace_exporter.hpp
+ * * @brief Chrome Trace Event JSON writer for timelines of measurements and zones
+ *
+ * @project Simple Runtime Analyzer
+ *
+ * @author Diego Osorio (ShineKnightDev)
+ *
+ * @copyright Copyright (c) 2025 Diego Osorio (ShineKnightDev)
+ * @license MIT License
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <format>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include "shineknightdev/sample_utilities.hpp"
+
+namespace sra
+{
+
+namespace detail
+{
+
+// Streams a trace in the Chrome Trace Event format read by Perfetto and chrome://tracing. Each report is one
+// process, threads are the cores or threads it ran on, and measurements are complete ("X") events
+class TraceWriter
+{
+public:
+    explicit TraceWriter(std::ostream& out) : out(out) { out << "{\"traceEvents\": ["; }
+
+    TraceWriter(const TraceWriter&) = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+
+    void process_name(int pid, std::string_view name) { metadata("process_name", pid, 0, "name", name); }
+
+    // Shown next to the process name, e.g. whether its timeline was recorded or reconstructed
+    void process_labels(int pid, std::string_view labels) { metadata("process_labels", pid, 0, "labels", labels); }
+
+    void thread_name(int pid, std::int64_t tid, std::string_view name)
+    {
+        metadata("thread_name", pid, tid, "name", name);
+    }
+
+    // Times in nanoseconds, written as the microseconds the format expects. `args` is the body of a JSON object
+    void complete(std::string_view name,
+                  std::string_view category,
+                  int pid,
+                  std::int64_t tid,
+                  double start_ns,
+                  double duration_ns,
+                  std::string_view args = {})
+    {
+        separator();
+        out << std::format("{{\"name\": \"{}\", \"cat\": \"{}\", \"ph\": \"X\", \"ts\": {:.3f}, \"dur\": {:.3f}, "
+                           "\"pid\": {}, \"tid\": {}, \"args\": {{{}}}}}",
+                           escape_json(std::string(name)), category, start_ns / 1000.0, duration_ns / 1000.0, pid,
+                           tid, args);
+    }
+
+    void finish() { out << "\n],\n\"displayTimeUnit\": \"ns\",\n\"otherData\": {\"source\": \"sra\"}}\n"; }
+
+private:
+    void metadata(std::string_view event, int pid, std::int64_t tid, std::string_view key, std::string_view value)
+    {
+        separator();
+        out << std::format("{{\"name\": \"{}\", \"ph\": \"M\", \"pid\": {}, \"tid\": {}, "
+                           "\"args\": {{\"{}\": \"{}\"}}}}",
+                           event, pid, tid, key, escape_json(std::string(value)));
+    }
+
+    void separator()
+    {
+        out << (first ? "\n" : ",\n");
+        first = false;
+    }
+
+    std::ostream& out;
+    bool first = true;
+};
+
+} // namespace detail
+
+} // namespace sra
@@ -0,0 +1,526 @@
+/**
+ * @file zone_profiler.hpp
+ * * @brief Scoped instrumentation zones recorded into per-thread ring buffers
+ *
+ * @project Simple Runtime Analyzer
+ *
+ * @author Diego Osorio (ShineKnightDev)
+ *
+ * @copyright Copyright (c) 2025 Diego Osorio (ShineKnightDev)
+ * @license MIT License
+ *
+ * SRA_ZONE("name") times the rest of the enclosing scope. Define SRA_DISABLE_ZONES before including this header to
+ * compile every zone out; the collector then reports nothing.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "shineknightdev/latency_histogram.hpp"
+#include "shineknightdev/runtime_analyzer.hpp"
+#include "shineknightdev/sample_utilities.hpp"
+#include "shineknightdev/trace_exporter.hpp"
+
+// Events each thread can hold between two collections, a power of two
+#ifndef SRA_ZONE_BUFFER_CAPACITY
+#    define SRA_ZONE_BUFFER_CAPACITY 8192
+#endif
+
+namespace sra
+{
+
+// Static description of one SRA_ZONE, events refer to it by address
+struct ZoneSite
+{
+    std::string_view name;
+    std::string_view file;
+    std::uint32_t line = 0;
+};
+
+namespace detail
+{
+
+struct ZoneEvent
+{
+    const ZoneSite* site = nullptr;
+    TscClock::ticks start = 0;
+    TscClock::ticks end = 0;
+    std::uint32_t depth = 0;
+};
+
+inline constexpr size_t zone_buffer_capacity = SRA_ZONE_BUFFER_CAPACITY;
+static_assert(std::has_single_bit(zone_buffer_capacity), "SRA_ZONE_BUFFER_CAPACITY must be a power of two");
+
+// Single-producer single-consumer ring. The owning thread pushes completed zones, the collector drains them. A full
+// ring drops the new event instead of waiting
+class ZoneBuffer
+{
+public:
+    explicit ZoneBuffer(std::uint32_t thread_index) noexcept : thread_index(thread_index) {}
+
+    void push(const ZoneEvent& event) noexcept
+    {
+        const auto position = head.load(std::memory_order_relaxed);
+        if (position - tail.load(std::memory_order_acquire) == zone_buffer_capacity)
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        events[position & (zone_buffer_capacity - 1)] = event;
+        head.store(position + 1, std::memory_order_release);
+    }
+
+    // Collector side, one drain at a time
+    template <typename Func>
+    void drain(Func&& func)
+    {
+        const auto end = head.load(std::memory_order_acquire);
+        auto position = tail.load(std::memory_order_relaxed);
+        for (; position != end; ++position) { func(events[position & (zone_buffer_capacity - 1)]); }
+        tail.store(position, std::memory_order_release);
+    }
+
+    [[nodiscard]] std::uint64_t take_dropped() noexcept { return dropped.exchange(0, std::memory_order_relaxed); }
+
+    const std::uint32_t thread_index;
+    std::uint32_t depth = 0; // Open zones of the owning thread, only touched by it
+
+private:
+    alignas(64) std::atomic<std::uint64_t> head{0};
+    alignas(64) std::atomic<std::uint64_t> tail{0};
+    alignas(64) std::atomic<std::uint64_t> dropped{0};
+    std::array<ZoneEvent, zone_buffer_capacity> events;
+};
+
+struct ZoneRegistry
+{
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ZoneBuffer>> buffers;
+    std::uint32_t next_thread = 0;
+};
+
+[[nodiscard]] inline ZoneRegistry& zone_registry()
+{
+    static ZoneRegistry registry;
+    return registry;
+}
+
+inline std::atomic<bool> zones_enabled{true};
+
+// Unfenced TSC read: a zone spans far more than the few instructions the CPU may reorder around it
+[[nodiscard]] inline TscClock::ticks zone_ticks() noexcept
+{
+#if SRA_HAS_TSC
+    if (TscClock::available()) return __rdtsc();
+#endif
+    return static_cast<TscClock::ticks>(SteadyClock::start());
+}
+
+// A zone tick paired with the trace epoch, so zone events line up with the timelines of profiles
+struct ZoneClockOrigin
+{
+    TscClock::ticks ticks = 0;
+    std::chrono::nanoseconds time{};
+};
+
+[[nodiscard]] inline const ZoneClockOrigin& zone_clock_origin() noexcept
+{
+    static const ZoneClockOrigin origin{zone_ticks(), trace_time()};
+    return origin;
+}
+
+[[nodiscard]] inline std::chrono::nanoseconds zone_trace_time(TscClock::ticks ticks) noexcept
+{
+    const auto& origin = zone_clock_origin();
+    const double elapsed_ns = ticks >= origin.ticks ? TscClock::to_nanoseconds(ticks - origin.ticks)
+                                                    : -TscClock::to_nanoseconds(origin.ticks - ticks);
+    return origin.time + std::chrono::nanoseconds(static_cast<std::int64_t>(elapsed_ns));
+}
+
+// Registered on the first zone of each thread. The registry keeps the buffer alive after the thread exits so its
+// last events can still be collected
+[[nodiscard]] inline ZoneBuffer& zone_buffer()
+{
+    thread_local const std::shared_ptr<ZoneBuffer> buffer = [] {
+        static_cast<void>(zone_clock_origin());
+        auto& registry = zone_registry();
+        std::scoped_lock lock(registry.mutex);
+        auto created = std::make_shared<ZoneBuffer>(registry.next_thread++);
+        registry.buffers.push_back(created);
+        return created;
+    }();
+    return *buffer;
+}
+
+} // namespace detail
+
+// Turns recording on or off at run time. A disabled zone costs one relaxed load
+inline void set_zones_enabled(bool enabled) noexcept
+{
+    detail::zones_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+// Times its own lifetime as one event of `site`. Use through SRA_ZONE
+class ZoneScope
+{
+public:
+    explicit ZoneScope(const ZoneSite& site) : site(&site)
+    {
+        if (!detail::zones_enabled.load(std::memory_order_relaxed)) return;
+        buffer = &detail::zone_buffer();
+        depth = buffer->depth++;
+        start = detail::zone_ticks();
+    }
+
+    ~ZoneScope()
+    {
+        if (buffer == nullptr) return;
+        const auto end = detail::zone_ticks();
+        --buffer->depth;
+        buffer->push({site, start, end, depth});
+    }
+
+    ZoneScope(const ZoneScope&) = delete;
+    ZoneScope& operator=(const ZoneScope&) = delete;
+
+private:
+    const ZoneSite* site;
+    detail::ZoneBuffer* buffer = nullptr;
+    TscClock::ticks start = 0;
+    std::uint32_t depth = 0;
+};
+
+// Aggregate of every event of one zone site
+struct ZoneStatistics
+{
+    const ZoneSite* site = nullptr;
+    size_t count = 0;
+    Fractional<std::chrono::nanoseconds> total{};
+    Fractional<std::chrono::nanoseconds> self{}; // Total minus the time spent in nested zones
+    Fractional<std::chrono::nanoseconds> min{};
+    Fractional<std::chrono::nanoseconds> max{};
+    LatencyHistogram histogram{5}; // Durations in nanoseconds, percentiles within 1.6%
+
+    [[nodiscard]] Fractional<std::chrono::nanoseconds> mean() const noexcept
+    {
+        return count > 0 ? total / static_cast<double>(count) : Fractional<std::chrono::nanoseconds>{};
+    }
+
+    [[nodiscard]] Fractional<std::chrono::nanoseconds> percentile(double q) const noexcept
+    {
+        return std::clamp(Fractional<std::chrono::nanoseconds>(histogram.percentile(q)), min, max);
+    }
+};
+
+// Call tree node: one per distinct path of nested zones, merged across threads. The root has no site
+struct ZoneNode
+{
+    const ZoneSite* site = nullptr;
+    size_t count = 0;
+    Fractional<std::chrono::nanoseconds> total{};
+    Fractional<std::chrono::nanoseconds> self{};
+    std::vector<ZoneNode> children;
+
+    void merge_child(ZoneNode&& child)
+    {
+        const auto it = std::ranges::find(children, child.site, &ZoneNode::site);
+        if (it == children.end())
+        {
+            children.push_back(std::move(child));
+            return;
+        }
+        it->count += child.count;
+        it->total += child.total;
+        it->self += child.self;
+        for (auto& grandchild : child.children) { it->merge_child(std::move(grandchild)); }
+    }
+};
+
+// One zone event on the trace timeline, kept when the collector keeps events
+struct ZoneTraceEvent
+{
+    const ZoneSite* site = nullptr;
+    std::uint32_t thread = 0;
+    std::uint32_t depth = 0;
+    TimedSpan span;
+};
+
+struct ZoneReport
+{
+    std::vector<ZoneStatistics> zones; // Sorted by total time, highest first
+    ZoneNode calls;
+    std::vector<ZoneTraceEvent> events; // In collection order, empty unless the collector keeps events
+    size_t threads = 0;
+    std::uint64_t dropped_events = 0; // Lost to full buffers, call trees may misplace zones around them
+};
+
+// Drains the zone buffers of every thread and aggregates the events. Call collect() periodically in long runs so
+// buffers do not fill up. Events go to whichever collector drains them first, so use one collector per program
+class ZoneCollector
+{
+public:
+    // Keeping events stores every zone for trace reports, memory then grows with the number of events
+    explicit ZoneCollector(bool keep_events = false) : keep_events(keep_events) {}
+
+    void collect()
+    {
+        auto& registry = detail::zone_registry();
+        std::vector<std::shared_ptr<detail::ZoneBuffer>> buffers;
+        {
+            std::scoped_lock lock(registry.mutex);
+            buffers.reserve(registry.buffers.size());
+            for (auto& buffer : registry.buffers)
+            {
+                // Only the registry owns the buffer of a thread that exited: drain it one last time and release it
+                if (buffer.use_count() == 1) { buffers.push_back(std::move(buffer)); }
+                else { buffers.push_back(buffer); }
+            }
+            std::erase(registry.buffers, nullptr);
+        }
+
+        std::scoped_lock lock(drain_mutex());
+        for (const auto& buffer : buffers)
+        {
+            auto& thread = threads[buffer->thread_index];
+            dropped_events += buffer->take_dropped();
+            buffer->drain([&](const detail::ZoneEvent& event) { add(thread, buffer->thread_index, event); });
+        }
+    }
+
+    // Collects, then returns everything aggregated since construction or the last reset
+    [[nodiscard]] ZoneReport report()
+    {
+        collect();
+
+        ZoneReport result;
+        result.zones.reserve(statistics.size());
+        for (const auto& [site, zone] : statistics) { result.zones.push_back(zone); }
+        std::ranges::sort(result.zones, std::ranges::greater{}, &ZoneStatistics::total);
+        result.calls = calls;
+        result.events = events;
+        result.threads = threads.size();
+        result.dropped_events = dropped_events;
+        return result;
+    }
+
+    void reset()
+    {
+        collect();
+        statistics.clear();
+        calls = {};
+        events.clear();
+        dropped_events = 0;
+        for (auto& [index, thread] : threads) { thread.pending.clear(); }
+    }
+
+private:
+    // Zones of a thread complete innermost first. pending[d] merges the finished subtrees at depth d until the
+    // enclosing zone at depth d - 1 completes and adopts them
+    struct ThreadState
+    {
+        std::vector<ZoneNode> pending;
+    };
+
+    [[nodiscard]] static std::mutex& drain_mutex()
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    void add(ThreadState& thread, std::uint32_t thread_index, const detail::ZoneEvent& event)
+    {
+        const Fractional<std::chrono::nanoseconds> duration(TscClock::to_nanoseconds(event.end - event.start));
+        if (keep_events)
+        {
+            events.push_back({event.site, thread_index, event.depth,
+                              {detail::zone_trace_time(event.start), detail::zone_trace_time(event.end)}});
+        }
+
+        auto& zone = statistics[event.site];
+        zone.site = event.site;
+        zone.min = zone.count == 0 ? duration : std::min(zone.min, duration);
+        zone.max = zone.count == 0 ? duration : std::max(zone.max, duration);
+        ++zone.count;
+        zone.total += duration;
+        zone.histogram.record(static_cast<std::uint64_t>(std::max(duration.count(), 0.0)));
+
+        const size_t depth = event.depth;
+        if (thread.pending.size() < depth + 2) { thread.pending.resize(depth + 2); }
+
+        ZoneNode node{event.site, 1, duration, duration, std::move(thread.pending[depth + 1].children)};
+        thread.pending[depth + 1].children.clear();
+        for (const auto& child : node.children) { node.self -= child.total; }
+        zone.self += node.self;
+
+        if (depth == 0) { calls.merge_child(std::move(node)); }
+        else { thread.pending[depth].merge_child(std::move(node)); }
+    }
+
+    std::unordered_map<const ZoneSite*, ZoneStatistics> statistics;
+    std::unordered_map<std::uint32_t, ThreadState> threads;
+    ZoneNode calls;
+    bool keep_events;
+    std::vector<ZoneTraceEvent> events;
+    std::uint64_t dropped_events = 0;
+};
+
+namespace detail
+{
+
+// Report writers, found by print_report, save_report and generate_report like those of the profiles
+
+inline void write_text_zone_node(std::ostream& out, const ZoneNode& node, size_t indent)
+{
+    for (const auto& child : node.children)
+    {
+        out << std::string(indent, ' ')
+            << std::format("{} | Count: {} | Total: {:.6g} ns | Self: {:.6g} ns\n", child.site->name, child.count,
+                           child.total.count(), child.self.count());
+        write_text_zone_node(out, child, indent + 2);
+    }
+}
+
+inline void write_text_report_impl(std::ostream& out, const ZoneReport& report)
+{
+    out << "Zones: " << report.zones.size() << " | Threads: " << report.threads
+        << " | Dropped events: " << report.dropped_events << "\n";
+    for (const auto& zone : report.zones)
+    {
+        out << std::format("Zone {} ({}:{}): | Count: {} | Total: {:.6g} ns | Self: {:.6g} ns | Mean: {:.6g} ns "
+                           "| P50: {:.6g} ns | P99: {:.6g} ns | Max: {:.6g} ns\n",
+                           zone.site->name, zone.site->file, zone.site->line, zone.count, zone.total.count(),
+                           zone.self.count(), zone.mean().count(), zone.percentile(0.5).count(),
+                           zone.percentile(0.99).count(), zone.max.count());
+    }
+    if (!report.calls.children.empty())
+    {
+        out << "Call tree:\n";
+        write_text_zone_node(out, report.calls, 2);
+    }
+}
+
+inline void write_csv_report_impl(std::ostream& out, const ZoneReport& report)
+{
+    out << "zone,file,line,time_unit,count,total,self,mean,min,p50,p90,p99,max\n";
+    for (const auto& zone : report.zones)
+    {
+        out << std::format("{},{},{},ns,{},{},{},{},{},{},{},{},{}\n", zone.site->name, zone.site->file,
+                           zone.site->line, zone.count, zone.total.count(), zone.self.count(), zone.mean().count(),
+                           zone.min.count(), zone.percentile(0.5).count(), zone.percentile(0.9).count(),
+                           zone.percentile(0.99).count(), zone.max.count());
+    }
+}
+
+inline void write_json_zone_node(std::ostream& out, const ZoneNode& node, size_t indent)
+{
+    for (size_t i = 0; i < node.children.size(); ++i)
+    {
+        const auto& child = node.children[i];
+        out << (i > 0 ? ",\n" : "\n") << std::string(indent, ' ')
+            << std::format("{{\"zone\": \"{}\", \"count\": {}, \"total\": {}, \"self\": {}, \"children\": [",
+                           escape_json(std::string(child.site->name)), child.count, child.total.count(),
+                           child.self.count());
+        if (!child.children.empty())
+        {
+            write_json_zone_node(out, child, indent + 2);
+            out << "\n" << std::string(indent, ' ');
+        }
+        out << "]}";
+    }
+}
+
+inline void write_json_report_impl(std::ostream& out, const ZoneReport& report)
+{
+    out << "{\n"
+        << "  \"threads\": " << report.threads << ",\n"
+        << "  \"dropped_events\": " << report.dropped_events << ",\n"
+        << "  \"time_unit\": \"ns\",\n"
+        << "  \"zones\": [";
+    for (size_t i = 0; i < report.zones.size(); ++i)
+    {
+        const auto& zone = report.zones[i];
+        out << (i > 0 ? ",\n" : "\n")
+            << std::format("    {{\"zone\": \"{}\", \"file\": \"{}\", \"line\": {}, \"count\": {}, \"total\": {}, "
+                           "\"self\": {}, \"mean\": {}, \"min\": {}, \"p50\": {}, \"p90\": {}, \"p99\": {}, "
+                           "\"max\": {}}}",
+                           escape_json(std::string(zone.site->name)), escape_json(std::string(zone.site->file)),
+                           zone.site->line, zone.count, zone.total.count(), zone.self.count(), zone.mean().count(),
+                           zone.min.count(), zone.percentile(0.5).count(), zone.percentile(0.9).count(),
+                           zone.percentile(0.99).count(), zone.max.count());
+    }
+    out << "\n  ],\n  \"calls\": [";
+    write_json_zone_node(out, report.calls, 4);
+    out << "\n  ]\n}\n";
+}
+
+// One thread per recording thread, one event per kept zone event
+inline void append_trace_events(TraceWriter& trace, int pid, const ZoneReport& report)
+{
+    trace.process_name(pid, "Zones");
+    if (report.events.empty()) { trace.process_labels(pid, "no zone events kept"); }
+
+    std::vector<bool> named;
+    for (const auto& event : report.events)
+    {
+        if (named.size() <= event.thread) { named.resize(event.thread + 1); }
+        if (!named[event.thread])
+        {
+            trace.thread_name(pid, event.thread, std::format("thread {}", event.thread));
+            named[event.thread] = true;
+        }
+
+        const auto& site = *event.site;
+        trace.complete(site.name, "zone", pid, event.thread, static_cast<double>(event.span.start.count()),
+                       static_cast<double>((event.span.end - event.span.start).count()),
+                       std::format("\"file\": \"{}\", \"line\": {}, \"depth\": {}",
+                                   escape_json(std::string(site.file)), site.line, event.depth));
+    }
+}
+
+inline void write_trace_report_impl(std::ostream& out, const ZoneReport& report)
+{
+    TraceWriter trace(out);
+    append_trace_events(trace, 1, report);
+    trace.finish();
+}
+
+} // namespace detail
+
+} // namespace sra
+
+#define SRA_ZONE_CONCAT_IMPL(a, b) a##b
+#define SRA_ZONE_CONCAT(a, b) SRA_ZONE_CONCAT_IMPL(a, b)
+
+// Unique per use in a translation unit, so zones on one line, e.g. from another macro, do not collide
+#ifdef __COUNTER__
+#    define SRA_ZONE_UNIQUE_ID __COUNTER__
+#else
+#    define SRA_ZONE_UNIQUE_ID __LINE__
+#endif
+
+#if defined(SRA_DISABLE_ZONES)
+#    define SRA_ZONE(name) static_cast<void>(0)
+#else
+// Expands the unique id once, so the site and the scope share it
+#    define SRA_ZONE_IMPL(name, id)                                                                                  \
+        static constexpr ::sra::ZoneSite SRA_ZONE_CONCAT(sra_zone_site_, id){name, __FILE__, __LINE__};              \
+        const ::sra::ZoneScope SRA_ZONE_CONCAT(sra_zone_, id)(SRA_ZONE_CONCAT(sra_zone_site_, id))
+// Times the rest of the enclosing scope. `name` must be a string literal
+#    define SRA_ZONE(name) SRA_ZONE_IMPL(name, SRA_ZONE_UNIQUE_ID)
+#endif
@@ -16,8 +16,11 @@ import sys
 import os
 import csv
 import json
+import math
+import struct
 from pathlib import Path
-from typing import Tuple, List, Dict, Any
+from typing import Tuple, List, Dict, Any, Optional
+import numpy as np
 import matplotlib
 import matplotlib.pyplot as plt
 matplotlib.use('QtAgg')
@@ -40,6 +43,24 @@ plt.rcParams.update({
     'legend.labelcolor': '#FFFFFF'    # Legend text
 })
 
+# Scaling reports (profile_scaling) plot throughput against the thread count
+SCALING_FIELDS = ('threads', 'throughput')
+RUNTIME_FIELDS = ('sample_size', 'time_value')
+
+# Binary profiles (.srp): 64-byte header, then 64-byte column descriptors, metadata and 64-byte aligned columns
+SRP_HEADER = struct.Struct('<8sIIQIIqq16s')
+SRP_COLUMN = struct.Struct('<40sIIQQ')
+SRP_TYPES = {1: np.float64, 2: np.uint64, 3: np.int64}
+
+# Basis functions of the complexity classes fitted by fit_complexity (natural logarithms)
+COMPLEXITY_BASIS = {
+    'O(log n)': math.log,
+    'O(n)': lambda n: n,
+    'O(n log n)': lambda n: n * math.log(n),
+    'O(n^2)': lambda n: n ** 2,
+    'O(n^3)': lambda n: n ** 3,
+}
+
 # Color palette for multiple datasets
 COLOR_PALETTE = [
     '#FF6B00',  # orange (first dataset)
@@ -55,10 +76,11 @@ COLOR_PALETTE = [
 ]
 
 
-def read_csv(file_path: Path) -> Tuple[List[int], List[float], str]:
+def read_csv(file_path: Path) -> Tuple[List[int], List[float], str, bool]:
     """Read data from a CSV file."""
     sizes, times = [], []
     unit = "units"
+    scaling = False
 
     try:
         with open(file_path, 'r', newline='', encoding='utf-8') as f:
@@ -73,21 +95,22 @@ def read_csv(file_path: Path) -> Tuple[List[int], List[float], str]:
             if not reader.fieldnames:
                 print(
                     f"❌ Error: CSV file '{file_path}' has no headers or is empty")
-                return sizes, times, unit
+                return sizes, times, unit, scaling
 
-            required_fields = ['sample_size', 'time_value']
+            scaling = 'threads' in reader.fieldnames
+            required_fields = SCALING_FIELDS if scaling else RUNTIME_FIELDS
             if not all(field in reader.fieldnames for field in required_fields):
                 print(
                     f"❌ Error: CSV file '{file_path}' missing required columns. Found: {reader.fieldnames}")
-                return sizes, times, unit
+                return sizes, times, unit, scaling
 
             row_count = 0
             for row in reader:
                 row_count += 1
                 try:
-                    size = int(row.get('sample_size', 0))
-                    time = float(row.get('time_value', 0.0))
-                    unit = row.get('time_unit', unit)
+                    size = int(row.get(required_fields[0], 0))
+                    time = float(row.get(required_fields[1], 0.0))
+                    unit = 'ops/s' if scaling else row.get('time_unit', unit)
 
                     if size <= 0 or time < 0:
                         print(
@@ -107,30 +130,46 @@ def read_csv(file_path: Path) -> Tuple[List[int], List[float], str]:
 
     except Exception as e:
         print(f"❌ Error reading CSV file '{file_path}': {e}")
-        return sizes, times, unit
+        return sizes, times, unit, scaling
 
-    return sizes, times, unit
+    return sizes, times, unit, scaling
 
 
-def read_json(file_path: Path) -> Tuple[List[int], List[float], str]:
-    """Read data from a JSON file."""
+def read_json(file_path: Path) -> Tuple[List[int], List[float], str, bool, Optional[Dict[str, Any]]]:
+    """Read data from a JSON or JSON-lines file."""
     sizes, times = [], []
     unit = "units"
+    scaling = False
+    fit = None
 
     try:
         with open(file_path, 'r', encoding='utf-8') as f:
-            data = json.load(f)
+            if file_path.suffix.lower() == '.jsonl':
+                # JSON lines from a streaming sink, one sample per line
+                data = [json.loads(line) for line in f if line.strip()]
+            else:
+                data = json.load(f)
     except json.JSONDecodeError as e:
         print(f"❌ JSON decode error in '{file_path}': {e}")
-        return sizes, times, unit
+        return sizes, times, unit, scaling, fit
     except Exception as e:
         print(f"❌ Error reading JSON file '{file_path}': {e}")
-        return sizes, times, unit
+        return sizes, times, unit, scaling, fit
+
+    # JSON reports wrap the samples in an object, reports of earlier versions are a plain array
+    if isinstance(data, dict) and 'samples' in data:
+        complexity = data.get('complexity') or {}
+        fit = next((f for f in complexity.get('fits', [])
+                    if f.get('class') == complexity.get('best_fit')), None)
+        data = data['samples']
 
     if not isinstance(data, list):
         print(
             f"❌ Error: JSON file '{file_path}' should contain a list of objects")
-        return sizes, times, unit
+        return sizes, times, unit, scaling, fit
+
+    scaling = bool(data) and isinstance(data[0], dict) and 'threads' in data[0]
+    x_field, y_field = SCALING_FIELDS if scaling else RUNTIME_FIELDS
 
     entry_count = 0
     for entry in data:
@@ -141,9 +180,9 @@ def read_json(file_path: Path) -> Tuple[List[int], List[float], str]:
                     f"⚠️ Skipping non-dictionary entry {entry_count} in {file_path}")
                 continue
 
-            size = int(entry.get('sample_size', 0))
-            time = float(entry.get('time_value', 0.0))
-            unit = entry.get('time_unit', unit)
+            size = int(entry.get(x_field, 0))
+            time = float(entry.get(y_field, 0.0))
+            unit = 'ops/s' if scaling else entry.get('time_unit', unit)
 
             if size <= 0 or time < 0:
                 print(
@@ -160,21 +199,89 @@ def read_json(file_path: Path) -> Tuple[List[int], List[float], str]:
     if entry_count == 0:
         print(f"⚠️ Warning: JSON file '{file_path}' contains no valid entries")
 
-    return sizes, times, unit
+    return sizes, times, unit, scaling, fit
 
 
-def read_data(file_path: Path) -> Tuple[List[int], List[float], str, str]:
-    """Read data from CSV or JSON file based on extension."""
+def read_binary(file_path: Path) -> Tuple[List[int], List[float], str, Optional[Dict[str, Any]]]:
+    """Read a columnar binary profile, mapping its columns instead of parsing rows."""
+    sizes, times = [], []
+    unit = "units"
+    fit = None
+
+    try:
+        data = np.memmap(file_path, dtype=np.uint8, mode='r')
+        if data.size < SRP_HEADER.size:
+            print(f"❌ Error: Binary profile '{file_path}' is truncated")
+            return sizes, times, unit, fit
+
+        magic, version, byte_order, samples, column_count, metadata_size, _, _, symbol = \
+            SRP_HEADER.unpack_from(data, 0)
+        if magic != b'SRAPROF\0' or version != 1 or byte_order != 0x01020304:
+            print(f"❌ Error: '{file_path}' is not a binary profile of this version")
+            return sizes, times, unit, fit
+        unit = symbol.rstrip(b'\0').decode('utf-8')
+
+        columns = {}
+        for i in range(column_count):
+            name, kind, _, offset, count = SRP_COLUMN.unpack_from(data, SRP_HEADER.size + i * SRP_COLUMN.size)
+            columns[name.rstrip(b'\0').decode('utf-8')] = np.frombuffer(
+                data, dtype=SRP_TYPES[kind], count=count, offset=offset)
+
+        metadata_offset = SRP_HEADER.size + column_count * SRP_COLUMN.size
+        metadata = bytes(data[metadata_offset:metadata_offset + metadata_size]).decode('utf-8')
+    except (OSError, ValueError, KeyError, struct.error) as e:
+        print(f"❌ Error reading binary profile '{file_path}': {e}")
+        return sizes, times, unit, fit
+
+    if 'sample_size' not in columns or 'time_value' not in columns:
+        print(f"❌ Error: Binary profile '{file_path}' missing required columns. Found: {list(columns)}")
+        return sizes, times, unit, fit
+
+    valid = (columns['sample_size'] > 0) & (columns['time_value'] >= 0)
+    if not valid.all():
+        print(f"⚠️ Warning: Skipping {int((~valid).sum())} invalid samples in {file_path}")
+    sizes = columns['sample_size'][valid].astype(int).tolist()
+    times = columns['time_value'][valid].astype(float).tolist()
+    if samples == 0:
+        print(f"⚠️ Warning: Binary profile '{file_path}' contains no samples")
+
+    # Complexity fits are metadata lines "complexity_fit=class;intercept;coefficient;exponent;r_squared"
+    best = None
+    fits = {}
+    for line in metadata.splitlines():
+        key, _, value = line.partition('=')
+        if key == 'complexity_best':
+            best = value
+        elif key == 'complexity_fit':
+            name, *numbers = value.split(';')
+            intercept, coefficient, exponent, r_squared = map(float, numbers)
+            fits[name] = {'class': name, 'intercept': intercept, 'coefficient': coefficient,
+                          'exponent': exponent, 'r_squared': r_squared}
+    fit = fits.get(best)
+
+    return sizes, times, unit, fit
+
+
+def read_data(file_path: Path) -> Tuple[List[int], List[float], str, str, bool, Optional[Dict[str, Any]]]:
+    """Read data from CSV, JSON or binary profile file based on extension."""
     ext = file_path.suffix.lower()
 
     if ext == '.csv':
-        sizes, times, unit = read_csv(file_path)
-    elif ext == '.json':
-        sizes, times, unit = read_json(file_path)
+        sizes, times, unit, scaling = read_csv(file_path)
+        fit = None
+    elif ext in {'.json', '.jsonl'}:
+        sizes, times, unit, scaling, fit = read_json(file_path)
+    elif ext == '.srp':
+        sizes, times, unit, fit = read_binary(file_path)
+        scaling = False
     else:
         raise ValueError(f"❌ Unsupported file extension: {ext}")
 
-    return sizes, times, unit, file_path.stem
+    # Reports without a fit from the library are fitted here
+    if fit is None and not scaling and sizes:
+        fit = fit_complexity(sizes, times)
+
+    return sizes, times, unit, file_path.stem, scaling, fit
 
 
 def validate_data(sizes: List[int], times: List[float], filename: str) -> bool:
@@ -197,6 +304,43 @@ def validate_data(sizes: List[int], times: List[float], filename: str) -> bool:
     return True
 
 
+def predict_fit(fit: Dict[str, Any], n: float) -> float:
+    """Evaluate a complexity fit at sample size n."""
+    if fit['class'] == 'O(1)':
+        return fit['intercept']
+    if fit['class'] == 'O(n^k)':
+        return fit['coefficient'] * n ** fit['exponent']
+    return fit['intercept'] + fit['coefficient'] * COMPLEXITY_BASIS[fit['class']](n)
+
+
+def fit_complexity(sizes: List[int], times: List[float]) -> Optional[Dict[str, Any]]:
+    """Least-squares fit of each complexity class, same selection as the C++ fit_complexity."""
+    if len(set(sizes)) < 2 or min(sizes) < 1:
+        return None
+
+    mean_t = sum(times) / len(times)
+    total = sum((t - mean_t) ** 2 for t in times)
+    best = None
+
+    for name in ['O(1)', *COMPLEXITY_BASIS]:
+        if name == 'O(1)':
+            fit = {'class': name, 'intercept': mean_t, 'coefficient': 0.0}
+        else:
+            x = [COMPLEXITY_BASIS[name](n) for n in sizes]
+            mean_x = sum(x) / len(x)
+            variance = sum((v - mean_x) ** 2 for v in x)
+            covariance = sum((v - mean_x) * (t - mean_t) for v, t in zip(x, times))
+            slope = covariance / variance if variance > 0 else 0.0
+            fit = {'class': name, 'intercept': mean_t - slope * mean_x, 'coefficient': slope}
+
+        residual = sum((t - predict_fit(fit, n)) ** 2 for n, t in zip(sizes, times))
+        fit['r_squared'] = 1.0 - residual / total if total > 0 else float(residual == 0)
+        if best is None or (fit['coefficient'] >= 0 and fit['r_squared'] > best['r_squared']):
+            best = fit
+
+    return best
+
+
 def plot_metrics(
     datasets: List[Dict[str, Any]],
     output_path: Path
@@ -206,6 +350,11 @@ def plot_metrics(
         print("❌ Error: No valid datasets to plot")
         return
 
+    scaling = datasets[0]['scaling']
+    if any(dataset['scaling'] != scaling for dataset in datasets):
+        print("❌ Error: Cannot plot scaling reports together with runtime reports")
+        return
+
     fig, ax = plt.subplots(figsize=(12, 7))
 
     # Determine common time unit
@@ -247,11 +396,44 @@ def plot_metrics(
             label=label
         )
 
+        # Best complexity fit, drawn over the whole size range
+        if dataset['fit'] is not None:
+            fit = dataset['fit']
+            low, high = sizes_sorted[0], sizes_sorted[-1]
+            curve_sizes = [low + (high - low) * step / 100 for step in range(101)]
+            ax.plot(
+                curve_sizes,
+                [predict_fit(fit, n) for n in curve_sizes],
+                '--',
+                color=color,
+                linewidth=1,
+                alpha=0.6,
+                label=f"{dataset['label']} fit {fit['class']} (R²={fit['r_squared']:.3f})"
+            )
+
+        # Linear scaling from the single-thread throughput, for reference
+        if scaling and sizes_sorted[0] == 1:
+            ax.plot(
+                sizes_sorted,
+                [times_sorted[0] * threads for threads in sizes_sorted],
+                '--',
+                color=color,
+                linewidth=1,
+                alpha=0.6,
+                label=f"{dataset['label']} (ideal)"
+            )
+
     # Axes and style configuration
-    ax.set_xlabel('Sample Size', fontsize=12, fontweight='bold')
-    ax.set_ylabel(f'Time ({common_unit})', fontsize=12, fontweight='bold')
+    if scaling:
+        ax.set_xlabel('Threads', fontsize=12, fontweight='bold')
+        ax.set_ylabel(f'Throughput ({common_unit})', fontsize=12, fontweight='bold')
+        title = 'Throughput vs Thread Count'
+    else:
+        ax.set_xlabel('Sample Size', fontsize=12, fontweight='bold')
+        ax.set_ylabel(f'Time ({common_unit})', fontsize=12, fontweight='bold')
+        title = 'Execution Time vs Sample Size'
     ax.set_title(
-        'Execution Time vs Sample Size',
+        title,
         fontsize=14,
         fontweight='bold',
         pad=20
@@ -290,7 +472,7 @@ def main() -> None:
     """Main function of the script."""
     if len(sys.argv) < 2:
         print("Usage: python plot.py <data_file1> [<data_file2> ...]")
-        print("Supported formats: .csv, .json")
+        print("Supported formats: .csv, .json, .jsonl, .srp")
         print("Example: python plot.py data/report1.csv data/report2.json")
         print("Example: python plot.py results/*.csv")
         sys.exit(1)
@@ -305,21 +487,23 @@ def main() -> None:
             print(f"❌ Error: File '{file_path}' not found")
             continue
 
-        if file_path.suffix.lower() not in {'.csv', '.json'}:
+        if file_path.suffix.lower() not in {'.csv', '.json', '.jsonl', '.srp'}:
             print(
-                f"❌ Error: Unsupported file format for '{file_path}'. Use .csv or .json")
+                f"❌ Error: Unsupported file format for '{file_path}'. Use .csv, .json, .jsonl or .srp")
             continue
 
         try:
             print(f"📖 Reading data from: {file_path}")
-            sizes, times, unit, filename = read_data(file_path)
+            sizes, times, unit, filename, scaling, fit = read_data(file_path)
 
             if validate_data(sizes, times, file_path.name):
                 valid_datasets.append({
                     'sizes': sizes,
                     'times': times,
                     'unit': unit,
-                    'label': filename
+                    'label': filename,
+                    'scaling': scaling,
+                    'fit': fit
                 })
                 print(
                     f"✅ Successfully loaded {len(sizes)} data points from {file_path.name}")